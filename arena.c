@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------
+// file: arena.c
+//
+// Description: This file implements the ARENA module, a bump allocator
+//     over a single block reserved when the arena is created.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "arena.h"
+
+
+extern int arena_init(struct arena_t *arena, size_t size)
+{
+        int result = SUCCESS;
+
+        // round up so the whole block is a multiple of the alignment
+        size = (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+        arena->used = 0;
+        arena->size = size;
+        arena->base = aligned_alloc(ARENA_ALIGN, size);
+        if (arena->base == NULL) {
+                arena->size = 0;
+                result = -1;
+        }
+
+        return result;
+} // arena_init()
+
+
+
+extern void *arena_alloc(struct arena_t *arena, size_t size)
+{
+        void *block = NULL;
+
+        size = (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+        if (size <= arena->size - arena->used) {
+                block = arena->base + arena->used;
+                arena->used += size;
+                memset(block, 0, size);
+        }
+
+        return block;
+} // arena_alloc()
+
+
+
+extern void arena_reset(struct arena_t *arena)
+{
+        arena->used = 0;
+} // arena_reset()
+
+
+
+extern void arena_free(struct arena_t *arena)
+{
+        free(arena->base);
+        arena->base = NULL;
+        arena->size = 0;
+        arena->used = 0;
+} // arena_free()
+
+
+// end of arena.c
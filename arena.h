@@ -0,0 +1,46 @@
+// ----------------------------------------------------------------------
+// file: arena.h
+//
+// Description: This is the header file for the ARENA module. An arena
+//     is one block of memory obtained when it is created; objects are
+//     carved out of it with a bump pointer and are all released together
+//     by arena_reset() or arena_free(). Sessions, shoes and statistics
+//     live in arenas so that playing hands never touches the heap.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Alignment of every block returned by arena_alloc (one cache line, so
+// objects owned by different threads never share a line).
+#define ARENA_ALIGN 64
+
+struct arena_t {
+        unsigned char *base;
+        size_t size;
+        size_t used;
+};
+
+
+// Reserve 'size' bytes for the arena. This is the only allocation the
+// arena ever makes. Returns SUCCESS or -1.
+extern int arena_init(struct arena_t *arena, size_t size);
+
+
+// Return 'size' zeroed bytes from the arena, or NULL if it is full.
+extern void *arena_alloc(struct arena_t *arena, size_t size);
+
+
+// Forget everything allocated so far (the memory is kept).
+extern void arena_reset(struct arena_t *arena);
+
+
+// Give the arena's memory back to the system.
+extern void arena_free(struct arena_t *arena);
+
+#endif
+// end of arena.h
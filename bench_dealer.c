@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------
+// file: bench_dealer.c
+//
+// Description: This program benchmarks the dealer tables. It plays the
+//     same dealer hands from an infinite-deck shoe twice, once with the
+//     card-by-card score loop and once with a table walk, checks that
+//     both give the same totals, reports the time per dealer hand for
+//     each, and compares the distribution of the totals with the exact
+//     odds from dealer_odds_infinite().
+//     Usage: bench [hands]
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "common.h"
+#include "card.h"
+#include "score.h"
+#include "dealer.h"
+
+#define DEFAULT_HANDS 20000000L
+#define SEED 20161018
+
+
+// Return the time in nanoseconds.
+static double now_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+} // now_ns()
+
+
+// Return the outcome index (total - 17, bust last) of a final total.
+static int outcome(int total)
+{
+        return (total > BEST_SCORE ? DEALER_BUST : total) - (DRAW_SCORE + 1);
+} // outcome()
+
+
+// Play a dealer hand card by card, the way the engine used to, and
+// return its final total.
+static int play_reference(struct shoe_t *shoe, int hit_soft_17)
+{
+        struct score_t score;
+        int best;
+
+        score_reset(&score);
+        for (;;) {
+                best = score_best(score);
+                if (best > DRAW_SCORE + 1 ||
+                    (best == DRAW_SCORE + 1 &&
+                     !(hit_soft_17 && score.num_aces > 0 &&
+                       score.tot_other + score.num_aces < best))) {
+                        break;
+                }
+                score_update(&score, CARD_PATTERN(shoe_deal(shoe)));
+        }
+        return best > BEST_SCORE ? DEALER_BUST : best;
+} // play_reference()
+
+
+// Run one rule: time both ways, check them and their distribution.
+// Return the number of problems found.
+static int bench(int hit_soft_17, long hands)
+{
+        const struct dealer_table_t *table = dealer_table(hit_soft_17);
+        struct shoe_t shoe;
+        long counts[DEALER_OUTCOMES] = { 0 };
+        double prob[KING + 1];
+        double odds[DEALER_OUTCOMES];
+        double start;
+        double ref_ns;
+        double table_ns;
+        unsigned long ref_sum = 0;
+        unsigned long table_sum = 0;
+        int problems = 0;
+        long i;
+        int j;
+
+        // reference loop
+        shoe_init_infinite(&shoe, SEED);
+        start = now_ns();
+        for (i = 0; i < hands; ++i) {
+                int total = play_reference(&shoe, hit_soft_17);
+
+                ref_sum = ref_sum * 31 + total;
+                ++counts[outcome(total)];
+        }
+        ref_ns = (now_ns() - start) / hands;
+
+        // table walk on the same cards
+        shoe_init_infinite(&shoe, SEED);
+        start = now_ns();
+        for (i = 0; i < hands; ++i) {
+                table_sum = table_sum * 31 + dealer_walk(table, 0, &shoe);
+        }
+        table_ns = (now_ns() - start) / hands;
+
+        printf("%s: reference %.2f ns/hand, table %.2f ns/hand (x%.2f)\n",
+               hit_soft_17 ? "h17" : "s17", ref_ns, table_ns,
+               ref_ns / table_ns);
+        if (ref_sum != table_sum) {
+                printf("  the table walk does not match the reference\n");
+                ++problems;
+        }
+
+        // distribution against the exact odds
+        for (j = ACE; j <= KING; ++j) {
+                prob[j] = 1.0 / (KING - ACE + 1);
+        }
+        dealer_odds_infinite(table, 0, prob, odds);
+        for (j = 0; j < DEALER_OUTCOMES; ++j) {
+                double freq = (double)counts[j] / hands;
+                double sigma = sqrt(odds[j] * (1 - odds[j]) / hands);
+                double z = (freq - odds[j]) / sigma;
+
+                if (j == DEALER_OUTCOMES - 1) {
+                        printf("  bust");
+                } else {
+                        printf("  %4d", DRAW_SCORE + 1 + j);
+                }
+                printf(" exact %.6f simulated %.6f (z %+.2f)\n",
+                       odds[j], freq, z);
+                if (fabs(z) > 5) {
+                        ++problems;
+                }
+        }
+        return problems;
+} // bench()
+
+
+int main(int argc, char *argv[])
+{
+        long hands = DEFAULT_HANDS;
+        int problems;
+
+        if (argc > 1) {
+                hands = atol(argv[1]);
+        }
+        if (hands <= 0) {
+                fprintf(stderr, "Usage: %s [hands]\n", argv[0]);
+                return 1;
+        }
+        problems = bench(FALSE, hands) + bench(TRUE, hands);
+        if (problems > 0) {
+                printf("%d problems\n", problems);
+                return 1;
+        }
+        return 0;
+} // main()
+
+// end of bench_dealer.c
@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------------
+// file: blackopt.c
+//
+// Description: This is the main entry point for the strategy optimizer.
+//     It improves a hit/stand strategy one row at a time: for every up
+//     card in the row it simulates the current strategy with that cell
+//     set to stand and to hit, and keeps the better decision. All the
+//     candidates of a row are played in one simulator run from the same
+//     shoes (common random numbers), so only hands that reach the cell
+//     contribute to the difference, and chunks of the run are spread
+//     over the worker threads. Passes are repeated until no decision
+//     changes. The result is saved in the format blacksim -S loads.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include "common.h"
+#include "rng.h"
+#include "strategy.h"
+#include "stats.h"
+#include "sim.h"
+
+#define DEFAULT_HANDS 200000
+#define DEFAULT_PASSES 4
+
+
+static void usage(const char *name)
+{
+        fprintf(stderr,
+                "usage: %s -o out_file [-S start_file] [-n hands] "
+                "[-p passes]\n"
+                "          [-t threads] [-d decks] [-s seed]\n", name);
+} // usage()
+
+
+
+// Order the rows are optimized in: a hit only ever leads to a higher
+// total, so deciding the high totals first lets the low totals be
+// judged against their final follow-up play.
+static int row_order(int i)
+{
+        int row;
+        int high_hard = BEST_SCORE - 12 + 1;    // hard 21..12
+
+        if (i < high_hard) {
+                row = BEST_SCORE - STRATEGY_HARD_MIN - i;
+        } else if (i < high_hard + STRATEGY_SOFT_ROWS) {
+                row = STRATEGY_ROWS - 1 - (i - high_hard);
+        } else {
+                row = 11 - STRATEGY_HARD_MIN - (i - high_hard -
+                                                STRATEGY_SOFT_ROWS);
+        }
+
+        return row;
+} // row_order()
+
+
+
+// Improve one row; returns the number of decisions changed.
+static int optimize_row(struct strategy_t *current, int row,
+                        struct sim_config_t *config)
+{
+        static struct strategy_t candidates[2 * STRATEGY_UPCARDS];
+        struct stats_t totals[2 * STRATEGY_UPCARDS];
+        unsigned char best;
+        int changed = 0;
+
+        // candidate 2*up stands in the cell, 2*up+1 hits
+        for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                candidates[2 * up] = *current;
+                candidates[2 * up].action[row][up] = STRATEGY_STAND;
+                candidates[2 * up + 1] = *current;
+                candidates[2 * up + 1].action[row][up] = STRATEGY_HIT;
+                config->strategies[2 * up] = &candidates[2 * up];
+                config->strategies[2 * up + 1] = &candidates[2 * up + 1];
+        }
+        config->num_strategies = 2 * STRATEGY_UPCARDS;
+
+        if (sim_run(config, totals) != SUCCESS) {
+                return -1;
+        }
+
+        // a tie (usually: no hand reached the cell) keeps the decision
+        for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                if (totals[2 * up + 1].payoff > totals[2 * up].payoff) {
+                        best = STRATEGY_HIT;
+                } else if (totals[2 * up + 1].payoff < totals[2 * up].payoff) {
+                        best = STRATEGY_STAND;
+                } else {
+                        best = current->action[row][up];
+                }
+                if (best != current->action[row][up]) {
+                        current->action[row][up] = best;
+                        ++changed;
+                }
+        }
+
+        return changed;
+} // optimize_row()
+
+
+
+// *********************************************************************
+// **************************** M A I N ********************************
+// *********************************************************************
+int main(int argc, char *argv[])
+{
+        struct sim_config_t config;
+        struct strategy_t current;
+        struct stats_t totals;
+        const char *out_file = NULL;
+        const char *start_file = NULL;
+        int passes = DEFAULT_PASSES;
+        int changed;
+        int n;
+        int opt;
+
+        sim_config_default(&config);
+        config.hands = DEFAULT_HANDS;
+        while ((opt = getopt(argc, argv, "o:S:n:p:t:d:s:")) != -1) {
+                switch (opt) {
+                        case 'o':
+                                out_file = optarg;
+                                break;
+                        case 'S':
+                                start_file = optarg;
+                                break;
+                        case 'n':
+                                config.hands = strtoull(optarg, NULL, 0);
+                                break;
+                        case 'p':
+                                passes = atoi(optarg);
+                                break;
+                        case 't':
+                                config.threads = atoi(optarg);
+                                break;
+                        case 'd':
+                                config.decks = atoi(optarg);
+                                break;
+                        case 's':
+                                config.seed = strtoull(optarg, NULL, 0);
+                                break;
+                        default:
+                                usage(argv[0]);
+                                return 2;
+                }
+        }
+        if (out_file == NULL) {
+                usage(argv[0]);
+                return 2;
+        }
+
+        if (start_file == NULL) {
+                strategy_default(&current);
+        } else if (strategy_load(&current, start_file) != SUCCESS) {
+                perror("Error: unable to load the starting strategy");
+                return 1;
+        }
+
+        for (int pass = 0; pass < passes; ++pass) {
+                changed = 0;
+                for (int i = 0; i < STRATEGY_ROWS; ++i) {
+                        n = optimize_row(&current, row_order(i), &config);
+                        if (n < 0) {
+                                fprintf(stderr, "Error: the simulation "
+                                        "could not be run\n");
+                                return 1;
+                        }
+                        changed += n;
+                }
+                printf("pass %d: %d decisions changed\n", pass + 1, changed);
+                if (changed == 0) {
+                        break;
+                }
+                // fresh shoes for the next pass
+                config.seed = rng_stream_seed(config.seed, pass + 1);
+        }
+
+        // report how the final strategy does on its own
+        config.strategies[0] = &current;
+        config.num_strategies = 1;
+        if (sim_run(&config, &totals) == SUCCESS) {
+                printf("EV %+.5f over %llu hands\n", stats_ev(&totals),
+                       (unsigned long long)totals.hands);
+        }
+
+        if (strategy_save(&current, out_file) != SUCCESS) {
+                perror("Error: unable to save the strategy");
+                return 1;
+        }
+
+        return 0;
+} // main
+
+// end of blackopt.c
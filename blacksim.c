@@ -0,0 +1,492 @@
+// ----------------------------------------------------------------------
+// file: blacksim.c
+//
+// Description: This is the main entry point for the headless blackjack
+//     simulator. It plays the rules of the interactive game for as many
+//     hands as requested on several threads and prints the results.
+//     Each -S option adds a strategy file to play; several strategies
+//     are played from the same shoes so they can be compared.
+//     -A plays antithetic shoes and -V adds the control variate; the
+//     EV is then reported with the reduced confidence interval next to
+//     the plain one.
+//     -m picks how cards are dealt: "decks" (the default), "infinite",
+//     "fixed" with the composition given by -C as 13 comma-separated
+//     counts for ace through king, or "csm" (a continuous shuffling
+//     machine with -B cards waiting in its buffer).
+//     -R sets the rules as a comma-separated list: "h17" (the dealer
+//     hits soft 17) and "3to2" (a natural pays 3:2).
+//     -P sets the shuffle procedure of a shoe of decks as a string of
+//     steps: p (perfect), r (riffle), s (strip), b (box) and c (cut),
+//     e.g. "rrsrbc". -K sets the penetration: the cards dealt before
+//     the cut card comes out.
+//     -o streams the results of every batch to a file ("-" for the
+//     standard output) as CSV, or as JSON lines with -F json.
+//     -x saves checkpoints to a file every -X seconds (default 60) and
+//     at the end; -r resumes the run saved there, which must be given
+//     the same options (the number of threads may differ).
+//     The control variate of -V assumes that every card left is as
+//     likely as any other to come next, which only perfect shuffles
+//     give, so it cannot be combined with -P or a csm.
+//     -p places side bets on every hand of the first strategy, as a
+//     comma-separated list of "pp" (Perfect Pairs), "21+3" and "ll"
+//     (Lucky Ladies) or "all", and prints their EV next to the exact
+//     value for a full shoe.
+//     -d takes a comma-separated list of deck counts ("1,2,6,8") to run
+//     one simulation for each in a single pool of threads (see
+//     sim_run_jobs()), whose results are printed one after the other;
+//     several cannot be combined with -o, -x, -i or -p.
+//     -N pins the threads to CPUs spread over the NUMA nodes and prints
+//     the hands played per second on each node, and any threads that
+//     could not be pinned (they play unpinned).
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "common.h"
+#include "session.h"
+#include "strategy.h"
+#include "stats.h"
+#include "export.h"
+#include "sidebet.h"
+#include "sim.h"
+
+
+static void usage(const char *name)
+{
+        fprintf(stderr,
+                "usage: %s [-n hands] [-t threads] [-d decks,...] [-s seed]\n"
+                "          [-c chunk] [-i interval_ms] [-A] [-V] "
+                "[-S strategy_file]...\n"
+                "          [-m decks|infinite|fixed|csm] [-C a,2,...,k] "
+                "[-R h17,3to2]\n"
+                "          [-P shuffle_steps] [-K penetration] "
+                "[-B csm_buffer]\n"
+                "          [-o export_file] [-F csv|json] "
+                "[-x checkpoint_file] [-X seconds] [-r] [-N]\n"
+                "          [-p pp,21+3,ll|all]\n",
+                name);
+} // usage()
+
+
+
+// Parse "-C" counts; returns SUCCESS or -1.
+static int parse_composition(const char *arg, unsigned short *counts)
+{
+        char *end;
+        int result = SUCCESS;
+
+        for (int m = ACE; m <= KING && result == SUCCESS; ++m) {
+                counts[m] = (unsigned short)strtoul(arg, &end, 10);
+                if (end == arg || (m < KING && *end != ',') ||
+                    (m == KING && *end != '\0')) {
+                        result = -1;
+                }
+                arg = end + 1;
+        }
+
+        return result;
+} // parse_composition()
+
+
+
+// Parse "-d" deck counts into 'decks' (room for SIM_MAX_JOBS); returns
+// SUCCESS or -1.
+static int parse_decks(const char *arg, int *decks, int *num_decks)
+{
+        char *end;
+        int result = SUCCESS;
+
+        *num_decks = 0;
+        do {
+                if (*num_decks == SIM_MAX_JOBS) {
+                        result = -1;
+                        break;
+                }
+                decks[*num_decks] = (int)strtol(arg, &end, 10);
+                if (end == arg || (*end != ',' && *end != '\0')) {
+                        result = -1;
+                }
+                ++*num_decks;
+                arg = end + 1;
+        } while (result == SUCCESS && *end == ',');
+
+        return result;
+} // parse_decks()
+
+
+
+// Parse "-R" rules; returns SUCCESS or -1.
+static int parse_rules(char *arg, struct rules_t *rules)
+{
+        char *word;
+        int result = SUCCESS;
+
+        for (word = strtok(arg, ","); word != NULL && result == SUCCESS;
+             word = strtok(NULL, ",")) {
+                if (strcmp(word, "h17") == 0) {
+                        rules->hit_soft_17 = TRUE;
+                } else if (strcmp(word, "s17") == 0) {
+                        rules->hit_soft_17 = FALSE;
+                } else if (strcmp(word, "3to2") == 0) {
+                        rules->natural_payoff = 3;
+                } else if (strcmp(word, "even") == 0) {
+                        rules->natural_payoff = PAYOFF_WIN;
+                } else {
+                        result = -1;
+                }
+        }
+
+        return result;
+} // parse_rules()
+
+
+
+static void print_stats(FILE *out, const struct stats_t *stats)
+{
+        fprintf(out, "hands %llu  wins %llu  losses %llu  draws %llu  "
+                "EV %+.5f  variance %.5f",
+                (unsigned long long)stats->hands,
+                (unsigned long long)stats->wins,
+                (unsigned long long)stats->losses,
+                (unsigned long long)stats->draws,
+                stats_ev(stats), stats_variance(stats));
+} // print_stats()
+
+
+
+// Print the EV with the best estimator for the run next to the plain
+// sample mean, and how many times fewer hands the reduction needs for
+// the same precision.
+static void print_estimate(const struct stats_t *stats, int method)
+{
+        struct estimate_t plain;
+        struct estimate_t best;
+
+        if (stats_estimate(stats, STATS_PLAIN, &plain) != SUCCESS) {
+                return;
+        }
+        printf("  EV %+.5f +- %.5f", plain.ev, plain.half_width);
+        if (method != STATS_PLAIN &&
+            stats_estimate(stats, method, &best) == SUCCESS) {
+                printf("  reduced %+.5f +- %.5f", best.ev, best.half_width);
+                if (best.half_width > 0.0) {
+                        printf(" (x%.1f)",
+                               (plain.half_width * plain.half_width) /
+                               (best.half_width * best.half_width));
+                }
+        }
+} // print_estimate()
+
+
+
+static void print_nodes(const struct sim_nodes_t *nodes)
+{
+        for (int n = 0; n < nodes->num_nodes; ++n) {
+                const struct sim_node_t *node = &nodes->node[n];
+
+                printf("node %d: %d threads  hands %llu  %.2f s", node->id,
+                       node->workers, node->hands, node->seconds);
+                if (node->seconds > 0.0) {
+                        printf("  %.0f hands/s",
+                               node->hands / node->seconds);
+                }
+                if (node->unpinned > 0) {
+                        printf("  %d unpinned", node->unpinned);
+                }
+                printf("\n");
+        }
+} // print_nodes()
+
+
+
+// Each side bet's EV per unit bet, with its 95% confidence interval,
+// and the exact value.
+static void print_side(const struct sim_side_t *side, int sidebets)
+{
+        const struct sidebet_totals_t *t = &side->totals;
+
+        for (int k = 0; k < SIDEBET_KINDS; ++k) {
+                double n = t->bets[k];
+                double ev;
+                double var;
+
+                if (!(sidebets & (1 << k)) || n == 0) {
+                        continue;
+                }
+                ev = t->payoff[k] / n;
+                var = t->payoff_sq[k] / n - ev * ev;
+                printf("side %s: bets %llu  wins %llu  EV %+.5f +- %.5f  "
+                       "exact %+.5f\n", sidebet_name(k),
+                       (unsigned long long)t->bets[k],
+                       (unsigned long long)t->wins[k], ev,
+                       1.96 * sqrt(var / n), side->exact[k]);
+        }
+} // print_side()
+
+
+
+// Print the results of every strategy of a run.
+static void print_run(const struct stats_t *totals, int num, int method)
+{
+        struct estimate_t diff;
+
+        for (int i = 0; i < num; ++i) {
+                print_stats(stdout, &totals[i]);
+                printf("\n");
+                print_estimate(&totals[i], method);
+                if (i > 0 && stats_estimate_diff(&totals[i], &totals[0],
+                                                 &diff) == SUCCESS) {
+                        // same shoes, so the difference is tight
+                        printf("  vs #1 %+.5f +- %.5f", diff.ev,
+                               diff.half_width);
+                }
+                printf("\n");
+        }
+} // print_run()
+
+
+
+// Live totals of the first strategy go to stderr on one line.
+static void show_progress(const struct stats_t *live, int num, void *arg)
+{
+        fprintf(stderr, "\r");
+        print_stats(stderr, live);
+        fflush(stderr);
+} // show_progress()
+
+
+
+// *********************************************************************
+// **************************** M A I N ********************************
+// *********************************************************************
+int main(int argc, char *argv[])
+{
+        static struct strategy_t strategies[SIM_MAX_STRATEGIES];
+        static struct stats_t totals[SIM_MAX_JOBS][SIM_MAX_STRATEGIES];
+        struct sim_config_t config;
+        struct sim_config_t configs[SIM_MAX_JOBS];
+        const struct sim_config_t *jobs[SIM_MAX_JOBS];
+        struct stats_t *job_totals[SIM_MAX_JOBS];
+        int decks[SIM_MAX_JOBS];
+        int num_jobs = 1;
+        struct export_t export;
+        struct sim_nodes_t nodes;
+        struct sim_side_t side;
+        const char *export_path = NULL;
+        int export_format = EXPORT_CSV;
+        int method;
+        int result = SUCCESS;
+        int opt;
+        int n;
+
+        sim_config_default(&config);
+        decks[0] = config.decks;
+        while ((opt = getopt(argc, argv, "n:t:d:s:c:i:AVS:m:C:R:P:K:B:"
+                             "o:F:x:X:rNp:")) != -1) {
+                switch (opt) {
+                        case 'n':
+                                config.hands = strtoull(optarg, NULL, 0);
+                                break;
+                        case 't':
+                                config.threads = atoi(optarg);
+                                break;
+                        case 'd':
+                                if (parse_decks(optarg, decks,
+                                                &num_jobs) != SUCCESS) {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                break;
+                        case 's':
+                                config.seed = strtoull(optarg, NULL, 0);
+                                break;
+                        case 'c':
+                                config.chunk = strtoul(optarg, NULL, 0);
+                                break;
+                        case 'i':
+                                config.interval_ms = atoi(optarg);
+                                config.progress = show_progress;
+                                break;
+                        case 'A':
+                                config.antithetic = TRUE;
+                                break;
+                        case 'V':
+                                config.control = TRUE;
+                                break;
+                        case 'm':
+                                if (strcmp(optarg, "infinite") == 0) {
+                                        config.mode = SHOE_INFINITE;
+                                } else if (strcmp(optarg, "fixed") == 0) {
+                                        config.mode = SHOE_FIXED;
+                                } else if (strcmp(optarg, "csm") == 0) {
+                                        config.mode = SHOE_CSM;
+                                } else if (strcmp(optarg, "decks") == 0) {
+                                        config.mode = SHOE_DECKS;
+                                } else {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                break;
+                        case 'C':
+                                if (parse_composition(optarg,
+                                        config.composition) != SUCCESS) {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                break;
+                        case 'R':
+                                if (parse_rules(optarg,
+                                                &config.rules) != SUCCESS) {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                break;
+                        case 'P':
+                                if (strlen(optarg) > SHUFFLE_MAX_STEPS) {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                strcpy(config.shuffle, optarg);
+                                break;
+                        case 'K':
+                                config.penetration = atoi(optarg);
+                                break;
+                        case 'B':
+                                config.csm_buffer = atoi(optarg);
+                                break;
+                        case 'o':
+                                export_path = optarg;
+                                break;
+                        case 'x':
+                                config.checkpoint = optarg;
+                                break;
+                        case 'X':
+                                config.checkpoint_ms = atoi(optarg) * 1000;
+                                break;
+                        case 'r':
+                                config.resume = TRUE;
+                                break;
+                        case 'p':
+                                config.sidebets = sidebet_parse(optarg);
+                                if (config.sidebets <= 0) {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                config.side = &side;
+                                break;
+                        case 'N':
+                                config.numa = TRUE;
+                                config.nodes = &nodes;
+                                break;
+                        case 'F':
+                                if (strcmp(optarg, "json") == 0) {
+                                        export_format = EXPORT_JSON;
+                                } else if (strcmp(optarg, "csv") == 0) {
+                                        export_format = EXPORT_CSV;
+                                } else {
+                                        usage(argv[0]);
+                                        return 2;
+                                }
+                                break;
+                        case 'S':
+                                n = config.num_strategies;
+                                if (n == SIM_MAX_STRATEGIES) {
+                                        fprintf(stderr, "Error: too many "
+                                                "strategies\n");
+                                        return 2;
+                                }
+                                if (strategy_load(&strategies[n],
+                                                  optarg) != SUCCESS) {
+                                        perror(optarg);
+                                        return 1;
+                                }
+                                config.strategies[n] = &strategies[n];
+                                config.num_strategies = n + 1;
+                                break;
+                        default:
+                                usage(argv[0]);
+                                return 2;
+                }
+        }
+        if (config.control && (config.shuffle[0] != '\0' ||
+                        config.mode == SHOE_CSM)) {
+                fprintf(stderr, "Error: -V needs perfect shuffles\n");
+                return 2;
+        }
+        if (config.antithetic && config.mode == SHOE_FIXED &&
+            !shoe_reflect_keeps(config.composition)) {
+                fprintf(stderr, "Error: -A needs a composition with as many "
+                        "cards of each pattern as of its reflection\n"
+                        "(A-6, 2-K, 3-Q, 4-J, 5-10, 7-9)\n");
+                return 2;
+        }
+        if (num_jobs > 1 && (export_path != NULL || config.side != NULL ||
+                             config.checkpoint != NULL ||
+                             config.progress != NULL)) {
+                fprintf(stderr, "Error: several deck counts cannot be "
+                        "combined with -o, -x, -i or -p\n");
+                return 2;
+        }
+
+        if (export_path != NULL) {
+                if (export_open(&export, export_path,
+                                export_format) != SUCCESS) {
+                        perror(export_path);
+                        return 1;
+                }
+                config.export = &export;
+        }
+
+        // one job per deck count, each with the options above
+        for (int j = 0; j < num_jobs; ++j) {
+                configs[j] = config;
+                configs[j].decks = decks[j];
+                jobs[j] = &configs[j];
+                job_totals[j] = totals[j];
+        }
+        result = sim_run_jobs(jobs, num_jobs, job_totals);
+        if (export_path != NULL && export_close(&export) != SUCCESS) {
+                perror(export_path);
+                result = -1;
+        }
+        if (config.progress != NULL) {
+                fprintf(stderr, "\n");
+        }
+        if (result != SUCCESS && config.checkpoint != NULL) {
+                perror(config.checkpoint);
+        }
+        if (result != SUCCESS) {
+                fprintf(stderr, "Error: the simulation could not be run\n");
+        } else {
+                // per-hand variance is only valid without antithetic
+                // pairs; otherwise use the chunks as batches
+                if (config.antithetic) {
+                        method = config.control ?
+                                 STATS_BATCH_CONTROL : STATS_BATCH;
+                } else {
+                        method = config.control ? STATS_CONTROL : STATS_PLAIN;
+                }
+                n = (config.num_strategies > 0) ? config.num_strategies : 1;
+                for (int j = 0; j < num_jobs; ++j) {
+                        if (num_jobs > 1) {
+                                printf("decks %d\n", decks[j]);
+                        }
+                        print_run(totals[j], n, method);
+                }
+                if (config.side != NULL) {
+                        print_side(&side, config.sidebets);
+                }
+                if (config.nodes != NULL) {
+                        print_nodes(&nodes);
+                }
+        }
+
+        return result;
+} // main
+
+// end of blacksim.c
@@ -0,0 +1,314 @@
+// ----------------------------------------------------------------------
+// file: broadcast.c
+//
+// Description: This file implements the BROADCAST module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "common.h"
+#include "broadcast.h"
+
+#define LISTEN_BACKLOG 16
+#define WAKE_BUFFER_SIZE 64
+
+
+
+static int set_nonblocking(int fd)
+{
+        int flags = fcntl(fd, F_GETFL);
+
+        if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+                return -1;
+        }
+        return SUCCESS;
+} // set_nonblocking()
+
+
+
+// Wake the sender up; if the pipe is full it is awake anyway.
+static void wake_sender(struct broadcast_t *broadcast)
+{
+        char wake = 0;
+        ssize_t written = write(broadcast->wake[1], &wake, 1);
+
+        (void)written;
+} // wake_sender()
+
+
+
+static void drop_viewer(struct broadcast_t *broadcast, int i)
+{
+        close(broadcast->viewers[i].fd);
+        broadcast->viewers[i] = broadcast->viewers[--broadcast->num_viewers];
+        ++broadcast->num_dropped;
+} // drop_viewer()
+
+
+
+// Take every viewer waiting to connect.
+static void accept_viewers(struct broadcast_t *broadcast)
+{
+        int fd;
+
+        while ((fd = accept(broadcast->listen_fd, NULL, NULL)) >= 0) {
+                struct broadcast_viewer_t *viewer;
+
+                if (broadcast->num_viewers == BROADCAST_MAX_VIEWERS ||
+                    set_nonblocking(fd) != SUCCESS) {
+                        close(fd);
+                        continue;
+                }
+                viewer = &broadcast->viewers[broadcast->num_viewers++];
+                viewer->fd = fd;
+                pthread_mutex_lock(&broadcast->lock);
+                if (broadcast->head - broadcast->key <= BROADCAST_MAX_LAG) {
+                        viewer->pos = broadcast->key;
+                } else {
+                        // it will see the next redraw
+                        viewer->pos = broadcast->head;
+                }
+                pthread_mutex_unlock(&broadcast->lock);
+        }
+} // accept_viewers()
+
+
+
+// Send viewer i as much of the ring as its socket takes. Returns
+// SUCCESS, or -1 if the viewer was dropped.
+static int send_viewer(struct broadcast_t *broadcast, int i)
+{
+        struct broadcast_viewer_t *viewer = &broadcast->viewers[i];
+        uint64_t head;
+        uint64_t start = viewer->pos;
+        size_t offset = start % BROADCAST_RING_SIZE;
+        size_t size;
+        ssize_t sent;
+
+        pthread_mutex_lock(&broadcast->lock);
+        head = broadcast->head;
+        pthread_mutex_unlock(&broadcast->lock);
+        if (head - start > BROADCAST_MAX_LAG) {
+                drop_viewer(broadcast, i);
+                return -1;
+        }
+        if (head == start) {
+                return SUCCESS;
+        }
+
+        // the part of the backlog up to the end of the ring
+        size = head - start;
+        if (size > BROADCAST_RING_SIZE - offset) {
+                size = BROADCAST_RING_SIZE - offset;
+        }
+        sent = send(viewer->fd, broadcast->ring + offset, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        return SUCCESS;
+                }
+                drop_viewer(broadcast, i);
+                return -1;
+        }
+        viewer->pos += sent;
+
+        // the game may have lapped the bytes while they were being sent
+        pthread_mutex_lock(&broadcast->lock);
+        head = broadcast->head;
+        pthread_mutex_unlock(&broadcast->lock);
+        if (head - start > BROADCAST_RING_SIZE) {
+                drop_viewer(broadcast, i);
+                return -1;
+        }
+
+        return SUCCESS;
+} // send_viewer()
+
+
+
+static void *sender_main(void *arg)
+{
+        struct broadcast_t *broadcast = arg;
+        struct pollfd fds[BROADCAST_MAX_VIEWERS + 2];
+        char buffer[WAKE_BUFFER_SIZE];
+        uint64_t head;
+        int stopping;
+
+        for (;;) {
+                pthread_mutex_lock(&broadcast->lock);
+                head = broadcast->head;
+                stopping = broadcast->stopping;
+                pthread_mutex_unlock(&broadcast->lock);
+                if (stopping) {
+                        break;
+                }
+
+                fds[0].fd = broadcast->wake[0];
+                fds[0].events = POLLIN;
+                fds[1].fd = broadcast->listen_fd;
+                fds[1].events = POLLIN;
+                for (int i = 0; i < broadcast->num_viewers; ++i) {
+                        // a viewer that is up to date is only watched
+                        // for hanging up
+                        fds[i + 2].fd = broadcast->viewers[i].fd;
+                        fds[i + 2].events = broadcast->viewers[i].pos == head ?
+                                            POLLIN : POLLIN | POLLOUT;
+                }
+                if (poll(fds, broadcast->num_viewers + 2, -1) < 0) {
+                        continue;
+                }
+
+                if (fds[0].revents & POLLIN) {
+                        while (read(broadcast->wake[0], buffer,
+                                    sizeof(buffer)) > 0) {
+                        }
+                }
+                // backwards, as dropping moves the last viewer into i
+                for (int i = broadcast->num_viewers - 1; i >= 0; --i) {
+                        short events = fds[i + 2].revents;
+
+                        if ((events & POLLIN) &&
+                            recv(broadcast->viewers[i].fd, buffer,
+                                 sizeof(buffer), MSG_DONTWAIT) == 0) {
+                                drop_viewer(broadcast, i);
+                        } else if (events & (POLLERR | POLLHUP)) {
+                                drop_viewer(broadcast, i);
+                        } else if (events & POLLOUT) {
+                                send_viewer(broadcast, i);
+                        }
+                }
+                if (fds[1].revents & POLLIN) {
+                        accept_viewers(broadcast);
+                }
+        }
+
+        // last chance for the viewers to see the end of the game
+        for (int i = broadcast->num_viewers - 1; i >= 0; --i) {
+                send_viewer(broadcast, i);
+        }
+        while (broadcast->num_viewers > 0) {
+                close(broadcast->viewers[--broadcast->num_viewers].fd);
+        }
+
+        return NULL;
+} // sender_main()
+
+
+
+extern int broadcast_start(struct broadcast_t *broadcast, const char *path)
+{
+        struct sockaddr_un address;
+
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (strlen(path) >= sizeof(address.sun_path) ||
+            strlen(path) >= sizeof(broadcast->path)) {
+                errno = ENAMETOOLONG;
+                return -1;
+        }
+        strcpy(address.sun_path, path);
+        strcpy(broadcast->path, path);
+
+        if (arena_init(&broadcast->arena, BROADCAST_RING_SIZE + ARENA_ALIGN) !=
+            SUCCESS) {
+                return -1;
+        }
+        broadcast->ring = arena_alloc(&broadcast->arena, BROADCAST_RING_SIZE);
+        broadcast->head = 0;
+        broadcast->key = 0;
+        broadcast->stopping = FALSE;
+        broadcast->num_viewers = 0;
+        broadcast->num_dropped = 0;
+
+        broadcast->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (broadcast->listen_fd < 0) {
+                arena_free(&broadcast->arena);
+                return -1;
+        }
+        unlink(path);
+        if (bind(broadcast->listen_fd, (struct sockaddr *)&address,
+                 sizeof(address)) < 0 ||
+            listen(broadcast->listen_fd, LISTEN_BACKLOG) < 0 ||
+            set_nonblocking(broadcast->listen_fd) != SUCCESS ||
+            pipe(broadcast->wake) < 0) {
+                close(broadcast->listen_fd);
+                unlink(path);
+                arena_free(&broadcast->arena);
+                return -1;
+        }
+        set_nonblocking(broadcast->wake[0]);
+        set_nonblocking(broadcast->wake[1]);
+
+        pthread_mutex_init(&broadcast->lock, NULL);
+        if (pthread_create(&broadcast->sender, NULL, sender_main,
+                           broadcast) != 0) {
+                pthread_mutex_destroy(&broadcast->lock);
+                close(broadcast->wake[0]);
+                close(broadcast->wake[1]);
+                close(broadcast->listen_fd);
+                unlink(path);
+                arena_free(&broadcast->arena);
+                return -1;
+        }
+
+        return SUCCESS;
+} // broadcast_start()
+
+
+
+extern void broadcast_frame(struct broadcast_t *broadcast, const char *data,
+                            size_t size, int key)
+{
+        size_t offset;
+        size_t first;
+
+        if (size > BROADCAST_MAX_LAG) {
+                // no viewer could take it whole
+                return;
+        }
+
+        pthread_mutex_lock(&broadcast->lock);
+        offset = broadcast->head % BROADCAST_RING_SIZE;
+        first = BROADCAST_RING_SIZE - offset;
+        if (first >= size) {
+                memcpy(broadcast->ring + offset, data, size);
+        } else {
+                memcpy(broadcast->ring + offset, data, first);
+                memcpy(broadcast->ring, data + first, size - first);
+        }
+        if (key) {
+                broadcast->key = broadcast->head;
+        }
+        broadcast->head += size;
+        pthread_mutex_unlock(&broadcast->lock);
+
+        wake_sender(broadcast);
+} // broadcast_frame()
+
+
+
+extern void broadcast_stop(struct broadcast_t *broadcast)
+{
+        pthread_mutex_lock(&broadcast->lock);
+        broadcast->stopping = TRUE;
+        pthread_mutex_unlock(&broadcast->lock);
+        wake_sender(broadcast);
+        pthread_join(broadcast->sender, NULL);
+
+        pthread_mutex_destroy(&broadcast->lock);
+        close(broadcast->wake[0]);
+        close(broadcast->wake[1]);
+        close(broadcast->listen_fd);
+        unlink(broadcast->path);
+        arena_free(&broadcast->arena);
+} // broadcast_stop()
+
+
+// end of broadcast.c
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------
+// file: broadcast.h
+//
+// Description: This is the header file for the BROADCAST module. It
+//     fans the frames drawn by the TABLE module out to any number of
+//     spectators connected to a Unix socket (for example with
+//     "socat - UNIX-CONNECT:<path>" or "nc -U <path>").
+//
+//     Each frame is copied once into a shared ring buffer. A sender
+//     thread writes the ring straight to every viewer's socket, each
+//     viewer from its own position, so the game thread pays for one copy
+//     and one wake-up per frame however many viewers there are, and
+//     never waits for them. A viewer that falls more than
+//     BROADCAST_MAX_LAG bytes behind (or whose bytes are overwritten
+//     while being sent) is dropped. A new viewer starts at the last
+//     full redraw of the screen if it is still in the ring.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "arena.h"
+
+#define BROADCAST_RING_SIZE (1 << 20)
+#define BROADCAST_MAX_LAG (BROADCAST_RING_SIZE / 2)
+#define BROADCAST_MAX_VIEWERS 64
+#define BROADCAST_PATH_SIZE 108     // sun_path of a Unix socket
+
+struct broadcast_viewer_t {
+        int fd;
+        uint64_t pos;                   // ring bytes sent to it
+};
+
+struct broadcast_t {
+        char path[BROADCAST_PATH_SIZE];
+        int listen_fd;
+        int wake[2];                    // pipe that wakes the sender
+        struct arena_t arena;           // holds the ring
+        char *ring;
+        pthread_mutex_t lock;           // guards head, key and stopping
+        uint64_t head;                  // bytes ever put in the ring
+        uint64_t key;                   // where the last redraw starts
+        int stopping;
+        pthread_t sender;
+
+        // owned by the sender thread
+        int num_viewers;
+        struct broadcast_viewer_t viewers[BROADCAST_MAX_VIEWERS];
+        unsigned long long num_dropped;
+};
+
+
+// Listen for viewers on a Unix socket at 'path' (replacing a stale
+// socket there) and start the sender. Returns SUCCESS or -1.
+extern int broadcast_start(struct broadcast_t *broadcast, const char *path);
+
+
+// Queue a frame for every viewer. 'key' is TRUE if the frame starts a
+// full redraw, where new viewers can join.
+extern void broadcast_frame(struct broadcast_t *broadcast, const char *data,
+                            size_t size, int key);
+
+
+// Send what the viewers can take without waiting, disconnect them, stop
+// the sender and remove the socket.
+extern void broadcast_stop(struct broadcast_t *broadcast);
+
+#endif
+// end of broadcast.h
@@ -12,8 +12,17 @@
 // Modifications:
 // 2017-10-30 (P. Clark)
 //     Added card_init().
+// 2026-10-18
+//     Replaced the Suit_list/Pattern_list/Card_taken arrays with a shoe
+//     of packed card codes shuffled with Fisher-Yates. card_get() now
+//     deals from a module-level one-deck shoe.
+//     Added the infinite-deck and fixed-composition modes.
+//     Added shuffle procedures made of riffles, strips, box shuffles
+//     and cuts, each done with a few passes over the packed cards.
+//     Added the continuous shuffling machine mode.
 // ----------------------------------------------------------------------
 #include <stdlib.h>
+#include <string.h>
 #include <sys/times.h>
 #include "card.h"
 #include "common.h"
@@ -22,21 +31,24 @@
 
 #define NUM_SUITS 4
 #define CARDS_PER_SUIT 13
+#define STRIP_PACKETS 8    // average packets in a strip shuffle
+#define BOX_PILES 4        // piles of a box shuffle
 
 static unsigned int Deck_shuffled = FALSE;
-static int Random_card;
-static int Num_deals;
+static struct shoe_t Deck;
 
-unsigned char Suit_list[CARDS_PER_DECK];
-unsigned char Pattern_list[CARDS_PER_DECK];
-unsigned char Card_taken[CARDS_PER_DECK];
+// Antithetic pattern of each pattern (see shoe_reflect())
+static const unsigned char Reflection[KING + 1] = {
+        0, 6, KING, QUEEN, JACK, 10, ACE, 9, 8, 7, 5, 4, 3, 2
+};
 
 
 // This function must be called before the first call to card_get().
 extern void card_init(void)
 {
         // initialize the random number generator
-        srandom(times(NULL));
+        shoe_init(&Deck, 1, times(NULL));
+        Deck_shuffled = TRUE;
 }
 
 
@@ -54,74 +66,487 @@ extern void card_init(void)
 //     13 = King
 extern void card_get(unsigned char *suit, unsigned char *pattern)
 {
+        unsigned char code;
+
         if (!Deck_shuffled) {
-                // shuffle the deck
+                // card_init() was not called; use a fixed seed
+                shoe_init(&Deck, 1, 0);
+                Deck_shuffled = TRUE;
+        }
 
-                Num_deals = 0;
+        if ((suit == NULL) || (pattern == NULL)) {
+                exit(-1);
+        } else {
+                code = shoe_deal(&Deck);
+                *suit = CARD_SUIT(code);
+                *pattern = CARD_PATTERN(code);
+        }
+} // card_get()
 
-                // initialize suit list to hold 13 cards of each suit
-                int i = 0;
-                for (int k = 1; k <= NUM_SUITS; ++k) {                        
-                        for (int j = 0; j < CARDS_PER_SUIT; ++j) {       
-                                Suit_list[i] = k;
-                                ++i;
+
+
+extern int shoe_init(struct shoe_t *shoe, int num_decks, uint64_t seed)
+{
+        int result = SUCCESS;
+        int i = 0;
+
+        if (num_decks < 1 || num_decks > MAX_DECKS) {
+                result = -1;
+        } else {
+                // lay out 13 patterns of each suit for every deck
+                shoe->full[0] = 0;
+                for (int m = 1; m <= CARDS_PER_SUIT; ++m) {
+                        shoe->full[m] = num_decks * NUM_SUITS;
+                }
+                for (int d = 0; d < num_decks; ++d) {
+                        for (int k = 1; k <= NUM_SUITS; ++k) {
+                                for (int m = 1; m <= CARDS_PER_SUIT; ++m) {
+                                        shoe->cards[i++] = CARD_CODE(k, m);
+                                }
                         }
                 }
+                shoe->num_cards = i;
+                shoe->cut = i;
+                shoe->mode = SHOE_DECKS;
+                shoe->procedure[0] = '\0';
+                rng_seed(&shoe->rng, seed);
+                shoe_shuffle(shoe);
+        }
+
+        return result;
+} // shoe_init()
 
-                // initialize pattern list to hold 4 cards of each pattern
-                int n = 0;
-                for (int l = 0; l < NUM_SUITS; ++l) {
-                        for (int m = 1; m <= CARDS_PER_SUIT; ++m) {
-                                Pattern_list[n] = m;
-                                ++n;
+
+
+extern int shoe_init_infinite(struct shoe_t *shoe, uint64_t seed)
+{
+        // one deck holds the exact probabilities of any number of decks
+        shoe_init(shoe, 1, seed);
+        shoe->mode = SHOE_INFINITE;
+
+        return SUCCESS;
+} // shoe_init_infinite()
+
+
+
+extern int shoe_init_counts(struct shoe_t *shoe,
+                            const unsigned short counts[KING + 1],
+                            uint64_t seed)
+{
+        int i = 0;
+        int result = SUCCESS;
+
+        for (int m = ACE; m <= KING; ++m) {
+                i += counts[m];
+        }
+        if (i == 0 || i > MAX_SHOE_CARDS) {
+                result = -1;
+        } else {
+                // lay out the cards, giving them suits in turn
+                i = 0;
+                shoe->full[0] = 0;
+                for (int m = ACE; m <= KING; ++m) {
+                        shoe->full[m] = counts[m];
+                        for (int k = 0; k < counts[m]; ++k) {
+                                shoe->cards[i] = CARD_CODE(k % NUM_SUITS + 1,
+                                                           m);
+                                ++i;
                         }
                 }
+                shoe->num_cards = i;
+                shoe->cut = i;
+                shoe->mode = SHOE_FIXED;
+                shoe->procedure[0] = '\0';
+                rng_seed(&shoe->rng, seed);
+                shoe_restore(shoe);
+        }
 
-                // initialize Card_taken list to false
-                for (int h = 0; h < CARDS_PER_DECK; ++h) {
-                        Card_taken[h] = 0;
-                }
+        return result;
+} // shoe_init_counts()
 
-                Deck_shuffled = TRUE;
+
+
+// Priority of a card position in the treap: a fixed mix of the
+// position, which is as good as random because where cards go does not
+// depend on it, and keeps the shoe free of extra state.
+static inline uint32_t csm_priority(unsigned short id)
+{
+        uint32_t x = id * UINT32_C(0x9e3779b9);
+
+        x ^= x >> 16;
+        x *= UINT32_C(0x85ebca6b);
+        x ^= x >> 13;
+        return x;
+} // csm_priority()
+
+
+
+// Split the subtree 't' into its first 'k' cards (*first) and the rest
+// (*rest).
+static void csm_split(struct csm_t *csm, unsigned short t, int k,
+                      unsigned short *first, unsigned short *rest)
+{
+        int num_left;
+
+        if (t == CSM_NIL) {
+                *first = *rest = CSM_NIL;
+                return;
+        }
+        num_left = csm->size[csm->kid[t][0]];
+        if (k <= num_left) {
+                csm_split(csm, csm->kid[t][0], k, first, &csm->kid[t][0]);
+                *rest = t;
+        } else {
+                csm_split(csm, csm->kid[t][1], k - num_left - 1,
+                          &csm->kid[t][1], rest);
+                *first = t;
         }
+        csm->size[t] = 1 + csm->size[csm->kid[t][0]] +
+                       csm->size[csm->kid[t][1]];
+} // csm_split()
 
-        // Figure out the next card to give out
-        // Make sure you detect when all the cards have been dealt...
 
-        // choose a random card that has not already been chosen
-        do {
-                Random_card = (random() % CARDS_PER_DECK);
-        } while (Card_taken[Random_card] == 1);
-        
-        // assign the randomly chosen suit and pattern and mark the card as dealt
-        if ((suit == NULL) || (pattern == NULL)) {
-                exit(-1);
+
+// Put card 'id' into the subtree '*t' so that 'k' cards come before it.
+static void csm_insert(struct csm_t *csm, unsigned short *t,
+                       unsigned short id, int k)
+{
+        uint32_t priority = csm_priority(id);
+        int num_left;
+        int right;
+
+        while (*t != CSM_NIL && csm_priority(*t) > priority) {
+                // the card goes below this node; the side is random, so
+                // it is picked without a branch
+                ++csm->size[*t];
+                num_left = csm->size[csm->kid[*t][0]];
+                right = k > num_left;
+                k -= right * (num_left + 1);
+                t = &csm->kid[*t][right];
+        }
+        // the card takes this node's place, with the node split under it
+        csm_split(csm, *t, k, &csm->kid[id][0], &csm->kid[id][1]);
+        csm->size[id] = 1 + csm->size[csm->kid[id][0]] +
+                        csm->size[csm->kid[id][1]];
+        *t = id;
+} // csm_insert()
+
+
+
+// Take the first card out of the machine and return its position.
+static unsigned short csm_take(struct csm_t *csm)
+{
+        unsigned short *t = &csm->root;
+        unsigned short id;
+
+        while (csm->kid[*t][0] != CSM_NIL) {
+                --csm->size[*t];
+                t = &csm->kid[*t][0];
+        }
+        id = *t;
+        *t = csm->kid[id][1];
+
+        return id;
+} // csm_take()
+
+
+
+extern int shoe_init_csm(struct shoe_t *shoe, int num_decks, int buffer,
+                         uint64_t seed)
+{
+        int result = shoe_init(shoe, num_decks, seed);
+
+        if (result == SUCCESS &&
+            (buffer < 0 || buffer >= shoe->num_cards)) {
+                result = -1;
+        }
+        if (result == SUCCESS) {
+                // load the shuffled cards into the machine in order
+                shoe->mode = SHOE_CSM;
+                shoe->cut = 0;
+                shoe->csm.root = CSM_NIL;
+                shoe->csm.size[CSM_NIL] = 0;
+                shoe->csm.buffer = buffer;
+                for (int i = 0; i < shoe->num_cards; ++i) {
+                        csm_insert(&shoe->csm, &shoe->csm.root, i, i);
+                }
+        }
+
+        return result;
+} // shoe_init_csm()
+
+
+
+extern void shoe_restore(struct shoe_t *shoe)
+{
+        if (shoe->mode == SHOE_FIXED) {
+                // the cards are always some order of the composition
+                shoe->next = 0;
+                memcpy(shoe->left, shoe->full, sizeof(shoe->left));
         } else {
-                *suit = Suit_list[Random_card];
-                *pattern = Pattern_list[Random_card];
-                Card_taken[Random_card] = 1;
-                Num_deals++;
+                shoe_shuffle(shoe);
         }
+} // shoe_restore()
+
 
-        // if a full deck has been dealt, flag the deck for shuffling
-        if (Num_deals == CARDS_PER_DECK) {                
-                Deck_shuffled = FALSE;
+
+// Fisher-Yates: every card is swapped with a uniformly chosen card at
+// or before it.
+static void perfect(struct shoe_t *shoe)
+{
+        unsigned char *cards = shoe->cards;
+        unsigned char tmp;
+        uint32_t j;
+
+        for (uint32_t i = shoe->num_cards - 1; i > 0; --i) {
+                j = rng_below(&shoe->rng, i + 1);
+                tmp = cards[i];
+                cards[i] = cards[j];
+                cards[j] = tmp;
         }
+} // perfect()
 
-} // card_get()
 
 
-// end of card.c
+// Gilbert-Shannon-Reeds riffle: cut the cards binomially in two, then
+// interleave the packets, every interleaving being equally likely. Both
+// come from one random bit per card: a card of the result comes from
+// the bottom packet if its bit is set, so the cut is the number of
+// clear bits. 'tmp' holds num_cards bytes.
+static void riffle(struct shoe_t *shoe, unsigned char *tmp)
+{
+        uint64_t bits[(MAX_SHOE_CARDS + 63) / 64];
+        int n = shoe->num_cards;
+        int top = 0;
+        int bottom = n;
+        int bit;
+        int i;
+
+        for (i = 0; i * 64 < n; ++i) {
+                bits[i] = rng_next(&shoe->rng);
+                if (n - i * 64 < 64) {
+                        bits[i] &= (UINT64_C(1) << (n - i * 64)) - 1;
+                }
+                bottom -= __builtin_popcountll(bits[i]);
+        }
+        memcpy(tmp, shoe->cards, n);
+
+        for (i = 0; i < n; ++i) {
+                bit = (bits[i / 64] >> (i % 64)) & 1;
+                shoe->cards[i] = tmp[bit ? bottom : top];
+                bottom += bit;
+                top += 1 - bit;
+        }
+} // riffle()
+
+
+
+// Take packets off the top of the cards and stack them on a new pile,
+// which reverses the order of the packets but not of the cards in them.
+// A packet has 'size' +- 'spread' cards (uniformly), and the last of
+// 'max_packets' packets takes every card left.
+static void restack(struct shoe_t *shoe, unsigned char *tmp, int size,
+                    int spread, int max_packets)
+{
+        int n = shoe->num_cards;
+        int taken = 0;
+        int len;
 
+        for (int k = 1; taken < n; ++k) {
+                len = size - spread + rng_below(&shoe->rng, 2 * spread + 1);
+                if (len > n - taken || k == max_packets) {
+                        len = n - taken;
+                }
+                memcpy(tmp + n - taken - len, shoe->cards + taken, len);
+                taken += len;
+        }
+        memcpy(shoe->cards, tmp, n);
+} // restack()
 
 
 
+// Cut the cards once, somewhere in their middle half.
+static void cut(struct shoe_t *shoe, unsigned char *tmp)
+{
+        int n = shoe->num_cards;
+        int at = n / 4 + rng_below(&shoe->rng, n / 2 + 1);
 
+        memcpy(tmp, shoe->cards + at, n - at);
+        memcpy(tmp + n - at, shoe->cards, at);
+        memcpy(shoe->cards, tmp, n);
+} // cut()
 
 
 
+extern int shoe_set_shuffle(struct shoe_t *shoe, const char *procedure,
+                            int penetration)
+{
+        int result = SUCCESS;
+        int i;
 
+        if (shoe->mode != SHOE_DECKS || penetration < 0 ||
+            penetration > shoe->num_cards ||
+            strlen(procedure) > SHUFFLE_MAX_STEPS) {
+                result = -1;
+        }
+        for (i = 0; result == SUCCESS && procedure[i] != '\0'; ++i) {
+                switch (procedure[i]) {
+                        case SHUFFLE_PERFECT:
+                        case SHUFFLE_RIFFLE:
+                        case SHUFFLE_STRIP:
+                        case SHUFFLE_BOX:
+                        case SHUFFLE_CUT:
+                                break;
+                        default:
+                                result = -1;
+                                break;
+                }
+        }
+        if (result == SUCCESS) {
+                strcpy(shoe->procedure, procedure);
+                shoe->cut = penetration > 0 ? penetration : shoe->num_cards;
+        }
 
+        return result;
+} // shoe_set_shuffle()
 
 
 
+extern void shoe_shuffle(struct shoe_t *shoe)
+{
+        unsigned char tmp[MAX_SHOE_CARDS];
+        int n = shoe->num_cards;
+
+        if (shoe->mode == SHOE_CSM) {
+                // the discards go back behind the buffer, at random
+                for (int i = 0; i < shoe->next; ++i) {
+                        int count = n - shoe->next + i;
+                        int front = shoe->csm.buffer;
+
+                        if (front > count) {
+                                front = count;
+                        }
+                        csm_insert(&shoe->csm, &shoe->csm.root,
+                                   shoe->csm.tray[i],
+                                   front + rng_below(&shoe->rng,
+                                                     count - front + 1));
+                }
+                shoe->next = 0;
+                memcpy(shoe->left, shoe->full, sizeof(shoe->left));
+                return;
+        }
+        if (shoe->mode != SHOE_DECKS) {
+                // nothing to shuffle: cards are picked as they are dealt
+                shoe->next = 0;
+                memcpy(shoe->left, shoe->full, sizeof(shoe->left));
+                return;
+        }
+
+        if (shoe->procedure[0] == '\0') {
+                perfect(shoe);
+        }
+        for (const char *step = shoe->procedure; *step != '\0'; ++step) {
+                switch (*step) {
+                        case SHUFFLE_PERFECT:
+                                perfect(shoe);
+                                break;
+                        case SHUFFLE_RIFFLE:
+                                riffle(shoe, tmp);
+                                break;
+                        case SHUFFLE_STRIP:
+                                restack(shoe, tmp, n / STRIP_PACKETS + 1,
+                                        n / STRIP_PACKETS, n);
+                                break;
+                        case SHUFFLE_BOX:
+                                restack(shoe, tmp, n / BOX_PILES,
+                                        n / (BOX_PILES * 4), BOX_PILES);
+                                break;
+                        case SHUFFLE_CUT:
+                                cut(shoe, tmp);
+                                break;
+                }
+        }
+        shoe->next = 0;
+        memcpy(shoe->left, shoe->full, sizeof(shoe->left));
+} // shoe_shuffle()
+
+
+
+extern void shoe_reflect(struct shoe_t *shoe)
+{
+        unsigned char code;
+        unsigned short full[KING + 1];
+        unsigned short left[KING + 1];
+
+        for (int i = 0; i < shoe->num_cards; ++i) {
+                code = shoe->cards[i];
+                shoe->cards[i] = CARD_CODE(CARD_SUIT(code),
+                                           Reflection[CARD_PATTERN(code)]);
+        }
+
+        // the counts move with the patterns
+        full[0] = left[0] = 0;
+        for (int m = ACE; m <= KING; ++m) {
+                full[Reflection[m]] = shoe->full[m];
+                left[Reflection[m]] = shoe->left[m];
+        }
+        memcpy(shoe->full, full, sizeof(full));
+        memcpy(shoe->left, left, sizeof(left));
+} // shoe_reflect()
+
+
+
+extern int shoe_reflect_keeps(const unsigned short composition[KING + 1])
+{
+        for (int m = ACE; m <= KING; ++m) {
+                if (composition[m] != composition[Reflection[m]]) {
+                        return FALSE;
+                }
+        }
+
+        return TRUE;
+} // shoe_reflect_keeps()
+
+
+
+extern unsigned char shoe_deal(struct shoe_t *shoe)
+{
+        unsigned char *cards = shoe->cards;
+        unsigned char code;
+        uint32_t j;
+
+        if (shoe->mode == SHOE_INFINITE) {
+                // independent draw; the shoe never runs down
+                return cards[rng_below(&shoe->rng, shoe->num_cards)];
+        }
+
+        // if the whole shoe has been dealt, shuffle it again
+        if (shoe->next == shoe->num_cards) {
+                shoe_shuffle(shoe);
+        }
+
+        if (shoe->mode == SHOE_CSM) {
+                // the first card in the machine goes to the tray
+                j = csm_take(&shoe->csm);
+                shoe->csm.tray[shoe->next++] = j;
+                code = cards[j];
+                --shoe->left[CARD_PATTERN(code)];
+                return code;
+        }
+        if (shoe->mode == SHOE_FIXED) {
+                // pick one of the cards not dealt yet and move it to
+                // the dealt end (one step of Fisher-Yates)
+                j = shoe->next + rng_below(&shoe->rng,
+                                           shoe->num_cards - shoe->next);
+                code = cards[j];
+                cards[j] = cards[shoe->next];
+                cards[shoe->next] = code;
+        }
+        code = cards[shoe->next++];
+        --shoe->left[CARD_PATTERN(code)];
+
+        return code;
+} // shoe_deal()
+
+
+// end of card.c
@@ -11,10 +11,22 @@
 //     Added CARDS_PER_DECK macro.
 // 2017-10-30 (P. Clark)
 //     Added card_init() call.
+// 2026-10-18
+//     Added the shoe_t type so callers can own independent shoes of one
+//     or more decks, each with its own random number stream. Cards in a
+//     shoe are stored as packed one-byte codes.
+//     Added shoe_reflect() and shoe_reflect_keeps() for antithetic shoes.
+//     Added the infinite-deck and fixed-composition shoe modes.
+//     Added shuffle procedures (riffle, strip, box, cut) and a cut card
+//     for shoes that are reshuffled from their previous order.
+//     Added the continuous shuffling machine mode.
 // ----------------------------------------------------------------------
 #ifndef CARD_H
 #define CARD_H
 
+#include <stdint.h>
+#include "rng.h"
+
 #define CLUBS 1
 #define HEARTS 2
 #define SPADES 3
@@ -26,6 +38,59 @@
 #define KING 13
 
 #define CARDS_PER_DECK 52
+#define MAX_DECKS 8
+#define MAX_SHOE_CARDS (MAX_DECKS * CARDS_PER_DECK)
+
+// A card packed into one byte: suit in the high nibble, pattern in the
+// low nibble.
+#define CARD_CODE(suit, pattern) ((unsigned char)(((suit) << 4) | (pattern)))
+#define CARD_SUIT(code)    ((unsigned char)((code) >> 4))
+#define CARD_PATTERN(code) ((unsigned char)((code) & 0x0f))
+
+// How a shoe deals:
+#define SHOE_DECKS 0     // shuffled decks dealt in order
+#define SHOE_INFINITE 1  // independent draws from a full deck
+#define SHOE_FIXED 2     // without replacement from a given composition
+#define SHOE_CSM 3       // continuous shuffling machine
+
+// Steps of a shuffle procedure (see shoe_set_shuffle())
+#define SHUFFLE_PERFECT 'p'  // uniformly random (Fisher-Yates)
+#define SHUFFLE_RIFFLE 'r'   // Gilbert-Shannon-Reeds riffle
+#define SHUFFLE_STRIP 's'    // strip small packets off the top
+#define SHUFFLE_BOX 'b'      // cut into four piles and restack them
+#define SHUFFLE_CUT 'c'      // cut once near the middle
+#define SHUFFLE_MAX_STEPS 15
+
+// The cards inside a continuous shuffling machine, in the order they
+// will come out, as an implicit treap: a binary tree of card positions
+// (indexes into shoe_t.cards) ordered by where the cards are in the
+// machine, and heap-ordered by a fixed priority of each position, so
+// taking the first card or putting one back anywhere is O(log n).
+// CSM_NIL is an empty node (of size 0) that stands for no subtree.
+#define CSM_NIL MAX_SHOE_CARDS
+
+struct csm_t {
+        unsigned short root;                        // CSM_NIL when empty
+        unsigned short buffer;                      // cards ready to deal
+        unsigned short kid[MAX_SHOE_CARDS + 1][2];  // left, right subtree
+        unsigned short size[MAX_SHOE_CARDS + 1];    // cards in subtree
+        unsigned short tray[MAX_SHOE_CARDS];        // dealt this round
+};
+
+// A shoe of one or more decks. Everything it needs is inside the struct,
+// so a shoe can be embedded in another object, copied, or saved as is.
+struct shoe_t {
+        struct rng_t rng;
+        unsigned char mode;                 // SHOE_ value
+        unsigned short num_cards;           // cards in the full shoe
+        unsigned short next;                // position of next card dealt
+        unsigned short cut;                 // shuffle at a round from here
+        unsigned short full[KING + 1];      // cards of each pattern
+        unsigned short left[KING + 1];      // ...not dealt yet
+        char procedure[SHUFFLE_MAX_STEPS + 1];  // "" for a perfect one
+        unsigned char cards[MAX_SHOE_CARDS];
+        struct csm_t csm;                   // only for SHOE_CSM
+};
 
 
 // This function must be called before the first call to card_get.
@@ -47,6 +112,94 @@ extern void card_init(void);
 extern void card_get(unsigned char *suit, unsigned char *pattern);
 
 
+// Fill a shoe with 'num_decks' (1..MAX_DECKS) decks, seed its random
+// number stream and shuffle it. Returns SUCCESS or -1.
+extern int shoe_init(struct shoe_t *shoe, int num_decks, uint64_t seed);
+
+
+// Make an infinite-deck shoe: every card is drawn independently with
+// the exact probabilities of a full deck, so the shoe has no state to
+// keep beyond its random number stream. Returns SUCCESS.
+extern int shoe_init_infinite(struct shoe_t *shoe, uint64_t seed);
+
+
+// Make a shoe that deals without replacement from 'counts' cards of each
+// pattern (counts[ACE]..counts[KING]; counts[0] is ignored). Each card
+// is picked at random when it is dealt, so there is no shuffle to pay
+// for, and shoe_restore() puts the dealt cards back in constant time.
+// Returns SUCCESS, or -1 if the counts are empty or exceed
+// MAX_SHOE_CARDS.
+extern int shoe_init_counts(struct shoe_t *shoe,
+                            const unsigned short counts[KING + 1],
+                            uint64_t seed);
+
+
+// Make a continuous shuffling machine of 'num_decks' (1..MAX_DECKS)
+// decks. Cards are dealt from the front of the machine, and at the
+// start of every round (see shoe_round()) the cards dealt in the last
+// round go back in at uniformly random positions behind the 'buffer'
+// cards at the front, which have already left the shuffler and wait to
+// be dealt. Returns SUCCESS, or -1 if a count is out of range.
+extern int shoe_init_csm(struct shoe_t *shoe, int num_decks, int buffer,
+                         uint64_t seed);
+
+
+// Set how a shoe of decks is shuffled. 'procedure' is a string of
+// SHUFFLE_ steps applied in order to the cards in the order they were
+// left in by the last shoe, as a dealer shuffles the discards, so any
+// order a real shuffle fails to break up carries into the next shoe.
+// "" (the default) is one perfect shuffle, which forgets the old order.
+// 'penetration' is how many cards are dealt before the cut card comes
+// out; the shoe is then shuffled before the next round (see
+// shoe_round()). 0 deals the whole shoe. Returns SUCCESS, or -1 if the
+// shoe is not a shoe of decks, a step is unknown, there are more than
+// SHUFFLE_MAX_STEPS steps, or 'penetration' is out of range.
+extern int shoe_set_shuffle(struct shoe_t *shoe, const char *procedure,
+                            int penetration);
+
+
+// Shuffle every card back into the shoe. A continuous shuffling machine
+// takes back the cards dealt since the last round.
+extern void shoe_shuffle(struct shoe_t *shoe);
+
+
+// Start a round: shuffle if the cut card has come out (or the shoe is
+// empty).
+static inline void shoe_round(struct shoe_t *shoe)
+{
+        if (shoe->next >= shoe->cut) {
+                shoe_shuffle(shoe);
+        }
+} // shoe_round()
+
+
+// Put every dealt card back into a fixed-composition shoe (or shuffle
+// any other shoe).
+extern void shoe_restore(struct shoe_t *shoe);
+
+
+// Turn a shoe into its antithetic twin by swapping patterns that are
+// good for the player with ones that are bad for the player (ace <-> 6,
+// ten <-> 5, jack <-> 4, queen <-> 3, king <-> 2, 7 <-> 9). Because
+// shuffling only moves positions, a reflected shoe seeded like an
+// ordinary one deals the reflection of its cards for ever after. The
+// counts of the patterns move with them, so the twin plays the same
+// shoe only if its composition is symmetric (see shoe_reflect_keeps()),
+// as it is for whole decks.
+extern void shoe_reflect(struct shoe_t *shoe);
+
+
+// Return TRUE if shoe_reflect() keeps a shoe of 'composition' (cards of
+// each pattern, ACE..KING) as it is: every pattern has as many cards as
+// its reflection.
+extern int shoe_reflect_keeps(const unsigned short composition[KING + 1]);
+
+
+// Deal the next card of the shoe as a packed card code. As with
+// card_get(), the shoe is reshuffled once every card has been dealt.
+extern unsigned char shoe_deal(struct shoe_t *shoe);
+
+
 
 #endif
 // end of card.h
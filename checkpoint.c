@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------
+// file: checkpoint.c
+//
+// Description: This file implements the CHECKPOINT module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "common.h"
+#include "checkpoint.h"
+
+#define MAGIC "BJCKPT\r\n"
+#define MAGIC_SIZE 8
+#define FNV_PRIME UINT64_C(0x100000001b3)
+#define PATH_MAX_LEN 4096
+
+struct header_t {
+        char magic[MAGIC_SIZE];
+        uint32_t version;
+        uint32_t num_strategies;
+        uint64_t fingerprint;
+        uint64_t num_chunks;
+};
+
+
+
+extern uint64_t checkpoint_hash(uint64_t hash, const void *data,
+                                size_t size)
+{
+        const unsigned char *p = data;
+
+        for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ p[i]) * FNV_PRIME;
+        }
+
+        return hash;
+} // checkpoint_hash()
+
+
+
+// Write 'size' bytes and add them to the checksum. Returns SUCCESS or -1.
+static int put(FILE *out, const void *data, size_t size, uint64_t *sum)
+{
+        *sum = checkpoint_hash(*sum, data, size);
+        return fwrite(data, 1, size, out) == size ? SUCCESS : -1;
+} // put()
+
+
+
+// Read 'size' bytes and add them to the checksum. Returns SUCCESS or -1.
+static int get(FILE *in, void *data, size_t size, uint64_t *sum)
+{
+        if (fread(data, 1, size, in) != size) {
+                return -1;
+        }
+        *sum = checkpoint_hash(*sum, data, size);
+        return SUCCESS;
+} // get()
+
+
+
+extern int checkpoint_save(const char *path, const struct checkpoint_t *cp)
+{
+        struct header_t header;
+        char tmp_path[PATH_MAX_LEN];
+        uint64_t sum = CHECKPOINT_HASH_INIT;
+        FILE *out;
+        int result = SUCCESS;
+
+        if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp",
+                     path) >= (int)sizeof(tmp_path)) {
+                errno = ENAMETOOLONG;
+                return -1;
+        }
+        out = fopen(tmp_path, "wb");
+        if (out == NULL) {
+                return -1;
+        }
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, MAGIC_SIZE);
+        header.version = CHECKPOINT_VERSION;
+        header.num_strategies = cp->num_strategies;
+        header.fingerprint = cp->fingerprint;
+        header.num_chunks = cp->num_chunks;
+        if (put(out, &header, sizeof(header), &sum) != SUCCESS ||
+            put(out, cp->totals, sizeof(*cp->totals) * cp->num_strategies,
+                &sum) != SUCCESS ||
+            put(out, cp->done, CHECKPOINT_DONE_SIZE(cp->num_chunks),
+                &sum) != SUCCESS ||
+            fwrite(&sum, sizeof(sum), 1, out) != 1) {
+                result = -1;
+        }
+        if (fclose(out) != 0) {
+                result = -1;
+        }
+
+        if (result == SUCCESS) {
+                result = rename(tmp_path, path) == 0 ? SUCCESS : -1;
+        } else {
+                remove(tmp_path);
+        }
+
+        return result;
+} // checkpoint_save()
+
+
+
+extern int checkpoint_load(const char *path, struct checkpoint_t *cp)
+{
+        struct header_t header;
+        uint64_t sum = CHECKPOINT_HASH_INIT;
+        uint64_t saved_sum;
+        FILE *in;
+        int result = SUCCESS;
+
+        in = fopen(path, "rb");
+        if (in == NULL) {
+                return -1;
+        }
+
+        if (get(in, &header, sizeof(header), &sum) != SUCCESS ||
+            memcmp(header.magic, MAGIC, MAGIC_SIZE) != 0 ||
+            header.version != CHECKPOINT_VERSION ||
+            header.fingerprint != cp->fingerprint ||
+            header.num_chunks != cp->num_chunks ||
+            header.num_strategies != (uint32_t)cp->num_strategies) {
+                result = -1;
+        }
+        if (result == SUCCESS &&
+            (get(in, cp->totals, sizeof(*cp->totals) * cp->num_strategies,
+                 &sum) != SUCCESS ||
+             get(in, cp->done, CHECKPOINT_DONE_SIZE(cp->num_chunks),
+                 &sum) != SUCCESS ||
+             fread(&saved_sum, sizeof(saved_sum), 1, in) != 1 ||
+             saved_sum != sum)) {
+                result = -1;
+        }
+        if (result != SUCCESS && !ferror(in)) {
+                // not a checkpoint of this run
+                errno = EINVAL;
+        }
+        fclose(in);
+
+        return result;
+} // checkpoint_load()
+
+
+// end of checkpoint.c
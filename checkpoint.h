@@ -0,0 +1,65 @@
+// ----------------------------------------------------------------------
+// file: checkpoint.h
+//
+// Description: This is the header file for the CHECKPOINT module. It
+//     saves and loads the progress of a simulation run in a compact
+//     binary file.
+//
+//     A run is made of chunks whose shoes and random number streams are
+//     set up from nothing but the run seed and the chunk number (see
+//     sim.h), so between chunks the only state worth saving is which
+//     chunks are finished and the integer totals they added up to. A
+//     resumed run plays the missing chunks and ends with exactly the
+//     totals of an uninterrupted run.
+//
+//     File layout (native byte order):
+//         header      magic, version, fingerprint of the run's
+//                     configuration, number of chunks and strategies
+//         totals      one stats_t per strategy
+//         done        one bit per chunk (chunk 0 in bit 0 of byte 0)
+//         checksum    FNV-1a of everything before it
+//     A checkpoint is written to "<path>.tmp" and renamed over <path>,
+//     so a crash while writing leaves the previous one intact.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include "stats.h"
+
+#define CHECKPOINT_VERSION 1
+
+struct checkpoint_t {
+        uint64_t fingerprint;       // of the configuration (see sim.c)
+        uint64_t num_chunks;
+        int num_strategies;
+        struct stats_t *totals;     // num_strategies entries
+        unsigned char *done;        // CHECKPOINT_DONE_SIZE(num_chunks)
+};
+
+// Bytes of the bitmap of done chunks
+#define CHECKPOINT_DONE_SIZE(num_chunks) (((num_chunks) + 7) / 8)
+
+
+// Mix 'size' bytes into a running FNV-1a hash. Start with
+// CHECKPOINT_HASH_INIT.
+#define CHECKPOINT_HASH_INIT UINT64_C(0xcbf29ce484222325)
+extern uint64_t checkpoint_hash(uint64_t hash, const void *data,
+                                size_t size);
+
+
+// Save a checkpoint. Returns SUCCESS or -1.
+extern int checkpoint_save(const char *path, const struct checkpoint_t *cp);
+
+
+// Load a checkpoint into 'cp', whose fingerprint, num_chunks and
+// num_strategies must already be those of the run to resume, and whose
+// totals and done arrays must have room for them. Returns SUCCESS, or
+// -1 if the file cannot be read, is damaged, or belongs to another run.
+extern int checkpoint_load(const char *path, struct checkpoint_t *cp);
+
+#endif
+// end of checkpoint.h
@@ -0,0 +1,245 @@
+// ----------------------------------------------------------------------
+// file: control.c
+//
+// Description: This file implements the CONTROL module. The values are
+//     worked out in doubles, from the end of a hand back to its first
+//     card, and rounded once into the table.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <string.h>
+#include <math.h>
+#include "common.h"
+#include "control.h"
+
+// Values of the states of one table, in bets
+struct values_t {
+        double prob[CONTROL_VALUES];    // of drawing each value
+        double stand[CONTROL_TOTALS][DEALER_STATES];
+        double play[CONTROL_HANDS][CONTROL_VALUES][CONTROL_VALUES];
+        double hole[CONTROL_HANDS][CONTROL_VALUES][CONTROL_VALUES];
+        double second[CONTROL_HANDS][CONTROL_VALUES];
+        double up[CONTROL_VALUES][CONTROL_VALUES];
+};
+
+
+
+static short round_value(double value)
+{
+        return (short)lround(value * CONTROL_SCALE);
+} // round_value()
+
+
+
+// Return the index of a hand with a card of value 'value' added.
+static int add_card(int hand, int value)
+{
+        int hard = hand / 2 + value;
+
+        if (hard > BEST_SCORE) {
+                hard = CONTROL_BUST;
+        }
+        return hard * 2 + ((hand % 2) || value == ACE);
+} // add_card()
+
+
+
+// Return the dealer's state after an up card and a hole card (values).
+static int dealer_start(const struct dealer_table_t *dealer, int up,
+                        int hole)
+{
+        struct score_t score = { 0, 0 };
+
+        score_update(&score, up);
+        return dealer->next[dealer_state(score)][hole];
+} // dealer_start()
+
+
+
+// The value of standing on each total against the dealer from each
+// state.
+static void compute_stand(const struct dealer_table_t *dealer,
+                          const double prob[KING + 1], struct values_t *v)
+{
+        double odds[DEALER_OUTCOMES];
+        double bust;
+
+        for (int s = 0; s < DEALER_STATES; ++s) {
+                dealer_odds_infinite(dealer, s, prob, odds);
+                bust = odds[DEALER_OUTCOMES - 1];
+                for (int t = 0; t < CONTROL_TOTALS; ++t) {
+                        int total = DRAW_SCORE + t;
+
+                        v->stand[t][s] = bust;
+                        for (int o = 0; o < DEALER_OUTCOMES - 1; ++o) {
+                                int dealt = DRAW_SCORE + 1 + o;
+
+                                if (t == 0 || dealt > total) {
+                                        v->stand[t][s] -= odds[o];
+                                } else if (dealt < total) {
+                                        v->stand[t][s] += odds[o];
+                                }
+                        }
+                }
+        }
+} // compute_stand()
+
+
+
+// The value of a hand while the player plays it, knowing the dealer's
+// two cards.
+static void compute_play(const struct dealer_table_t *dealer,
+                         const struct strategy_t *strategy,
+                         struct values_t *v)
+{
+        struct score_t score;
+        int hits;
+
+        for (int up = ACE; up <= 10; ++up) {
+                for (int hole = ACE; hole <= 10; ++hole) {
+                        int state = dealer_start(dealer, up, hole);
+
+                        v->play[CONTROL_BUST * 2][up][hole] = -1.0;
+                        v->play[CONTROL_BUST * 2 + 1][up][hole] = -1.0;
+
+                        // a hit only raises the hard total, so go down
+                        // from 21
+                        for (int hard = BEST_SCORE; hard >= 2; --hard) {
+                                for (int ace = 1; ace >= 0; --ace) {
+                                        int hand = hard * 2 + ace;
+                                        double value = 0;
+
+                                        score.num_aces = ace;
+                                        score.tot_other = hard - ace;
+                                        if (strategy == NULL) {
+                                                hits = score_best(score) <=
+                                                       DRAW_SCORE;
+                                        } else {
+                                                hits = strategy->action
+                                                       [strategy_row(score)]
+                                                       [strategy_upcard(up)]
+                                                       == STRATEGY_HIT;
+                                        }
+                                        if (!hits) {
+                                                v->play[hand][up][hole] =
+                                                        v->stand
+                                                        [control_total(score)]
+                                                        [state];
+                                                continue;
+                                        }
+                                        for (int c = ACE; c <= 10; ++c) {
+                                                value += v->prob[c] *
+                                                         v->play
+                                                         [add_card(hand, c)]
+                                                         [up][hole];
+                                        }
+                                        v->play[hand][up][hole] = value;
+                                }
+                        }
+                }
+        }
+} // compute_play()
+
+
+
+extern void control_compute(struct control_table_t *table,
+                            const struct rules_t *rules,
+                            const struct strategy_t *strategy,
+                            const unsigned short composition[KING + 1])
+{
+        const struct dealer_table_t *dealer =
+                dealer_table(rules->hit_soft_17);
+        struct values_t v;
+        double prob[KING + 1];
+        double total = 0;
+        double lead;
+        int natural;
+
+        memset(&v, 0, sizeof(v));
+        memset(table, 0, sizeof(*table));
+        for (int m = ACE; m <= KING; ++m) {
+                total += composition[m];
+        }
+        prob[0] = 0;
+        for (int m = ACE; m <= KING; ++m) {
+                prob[m] = composition[m] / total;
+                v.prob[control_value(m)] += prob[m];
+        }
+
+        compute_stand(dealer, prob, &v);
+        compute_play(dealer, strategy, &v);
+
+        // back to the first card, averaging over each card in turn; a
+        // natural is settled on the hole card, a draw if the dealer has
+        // 21 as well
+        for (int hand = 0; hand < CONTROL_HANDS; ++hand) {
+                for (int up = ACE; up <= 10; ++up) {
+                        for (int hole = ACE; hole <= 10; ++hole) {
+                                natural = up + hole == HIGH_ACE &&
+                                          (up == ACE || hole == ACE);
+                                if (hand != HIGH_ACE * 2 + 1) {
+                                        v.hole[hand][up][hole] =
+                                                v.play[hand][up][hole];
+                                } else if (!natural) {
+                                        v.hole[hand][up][hole] =
+                                                rules->natural_payoff / 2.0;
+                                }
+                                v.second[hand][up] += v.prob[hole] *
+                                                      v.hole[hand][up][hole];
+                        }
+                }
+        }
+        for (int first = ACE; first <= 10; ++first) {
+                for (int up = ACE; up <= 10; ++up) {
+                        for (int c = ACE; c <= 10; ++c) {
+                                v.up[first][up] += v.prob[c] *
+                                        v.second[add_card(first * 2 +
+                                                          (first == ACE),
+                                                          c)][up];
+                        }
+                }
+        }
+
+        // and round the value after each card into its row; pattern 0
+        // is never dealt
+        for (int m = ACE; m <= KING; ++m) {
+                int c = control_value(m);
+
+                lead = 0;
+                for (int up = ACE; up <= 10; ++up) {
+                        lead += v.prob[up] * v.up[c][up];
+                }
+                table->lead[m] = round_value(lead);
+                for (int first = ACE; first <= 10; ++first) {
+                        int hand = add_card(first * 2 + (first == ACE), c);
+
+                        table->up[first][m] = round_value(v.up[first][c]);
+                        for (int up = ACE; up <= 10; ++up) {
+                                table->second[first][up][m] =
+                                        round_value(v.second[hand][up]);
+                        }
+                }
+                for (int hand = 0; hand < CONTROL_HANDS; ++hand) {
+                        for (int up = ACE; up <= 10; ++up) {
+                                table->hole[hand][up][m] =
+                                        round_value(v.hole[hand][up][c]);
+                                for (int hole = ACE; hole <= 10; ++hole) {
+                                        table->hit[hand][up][hole][m] =
+                                                round_value(v.play
+                                                [add_card(hand, c)]
+                                                [up][hole]);
+                                }
+                        }
+                }
+                for (int t = 0; t < CONTROL_TOTALS; ++t) {
+                        for (int s = 0; s < DEALER_STATES; ++s) {
+                                table->dealer[t][s][m] = round_value(
+                                        v.stand[t][dealer->next[s][m]]);
+                        }
+                }
+        }
+} // control_compute()
+
+
+// end of control.c
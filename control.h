@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------
+// file: control.h
+//
+// Description: This is the header file for the CONTROL module. It
+//     builds the tables of the control variate that the engine adds up
+//     while it plays a hand (see session_play_hand()).
+//
+//     Every card dealt moves the hand from one state to the next: the
+//     player's first card, the up card, the player's second card, the
+//     hole card, each card the player hits and each card the dealer
+//     draws. A table holds the value of every state a card can lead to:
+//     the expected payoff of the hand from there on, for an infinite
+//     deck of the shoe's composition, with the player following the
+//     strategy and the dealer the rule the table was built for. The
+//     state after the last card of a hand is worth the payoff itself,
+//     so the changes in value card by card add up to the payoff less
+//     the value of the hand before it was dealt.
+//
+//     Each row is indexed by the pattern of the card about to be dealt,
+//     so the engine can weigh it by the cards of each pattern left in
+//     the shoe. Values are integers, in 1/CONTROL_SCALE of a bet, so
+//     that weighted mean is exact. The engine weighs each term by about
+//     CONTROL_WEIGHT over the cards left, rounded to an integer that
+//     depends only on the cards left, so a term counts the same however
+//     deep in the shoe it was dealt and its mean stays zero.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "card.h"
+#include "score.h"
+#include "strategy.h"
+#include "dealer.h"
+#include "engine.h"
+
+#define CONTROL_SCALE 8                 // values in eighths of a bet
+#define CONTROL_WEIGHT 1024             // scale of each card's term
+#define CONTROL_VALUES 11               // card values 1 (ace)..10
+#define CONTROL_BUST (BEST_SCORE + 1)   // hard total of any bust hand
+#define CONTROL_HANDS ((CONTROL_BUST + 1) * 2)  // hard total, ace or not
+#define CONTROL_TOTALS (BEST_SCORE - DRAW_SCORE + 1)   // 16 or less, 17..21
+
+struct control_table_t {
+        // after the player's first card
+        short lead[KING + 1];
+
+        // after the up card, by the value of the player's first card
+        short up[CONTROL_VALUES][KING + 1];
+
+        // after the player's second card, by the values of the first
+        // card and the up card
+        short second[CONTROL_VALUES][CONTROL_VALUES][KING + 1];
+
+        // after the hole card, by the player's two card hand (see
+        // control_hand()) and the up card's value; a natural is settled
+        // on it
+        short hole[CONTROL_HANDS][CONTROL_VALUES][KING + 1];
+
+        // after a card the player hits, by the player's hand before it
+        // and the values of the up card and the hole card
+        short hit[CONTROL_HANDS][CONTROL_VALUES][CONTROL_VALUES][KING + 1];
+
+        // after a card the dealer draws, by the player's total (see
+        // control_total()) and the dealer's state before the card
+        short dealer[CONTROL_TOTALS][DEALER_STATES][KING + 1];
+};
+
+
+// Fill in the table for the player's 'strategy' (NULL: the player
+// draws like the dealer), 'rules' and a shoe of 'composition' (cards of
+// each pattern, ACE..KING).
+extern void control_compute(struct control_table_t *table,
+                            const struct rules_t *rules,
+                            const struct strategy_t *strategy,
+                            const unsigned short composition[KING + 1]);
+
+
+// Return the value of a card (an ace counts 1).
+static inline int control_value(int pattern)
+{
+        return pattern < 10 ? pattern : 10;
+} // control_value()
+
+
+// Return the index of a player's hand: its hard total (CONTROL_BUST if
+// it is over) and whether it holds an ace.
+static inline int control_hand(struct score_t score)
+{
+        int hard = score.tot_other + score.num_aces;
+
+        if (hard > BEST_SCORE) {
+                hard = CONTROL_BUST;
+        }
+        return hard * 2 + (score.num_aces > 0);
+} // control_hand()
+
+
+// Return the index of the total a player stands on: 0 for DRAW_SCORE
+// or less, which only a dealer's bust beats, otherwise 1.. for
+// DRAW_SCORE + 1..
+static inline int control_total(struct score_t score)
+{
+        int best = score_best(score);
+
+        return best <= DRAW_SCORE ? 0 : best - DRAW_SCORE;
+} // control_total()
+
+#endif
+// end of control.h
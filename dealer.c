@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------
+// file: dealer.c
+//
+// Description: This file implements the DEALER module. The tables are
+//     built once, the first time they are asked for.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <pthread.h>
+#include <string.h>
+#include "common.h"
+#include "dealer.h"
+
+static struct dealer_table_t Tables[2];     // [hit_soft_17]
+static pthread_once_t Tables_once = PTHREAD_ONCE_INIT;
+
+
+
+// Fill in the table for one rule.
+static void build(struct dealer_table_t *table, int hit_soft_17)
+{
+        struct score_t score;
+        int hard;
+        int best;
+        int value;
+
+        for (int state = 0; state < DEALER_STATES; ++state) {
+                hard = state / 2;
+                score.num_aces = state % 2;
+                score.tot_other = hard - score.num_aces;
+                best = score_best(score);
+
+                // does the dealer stand here?
+                if (best > BEST_SCORE) {
+                        table->result[state] = DEALER_BUST;
+                } else if (best > DRAW_SCORE &&
+                           !(hit_soft_17 && best == DRAW_SCORE + 1 &&
+                             best != hard)) {
+                        table->result[state] = best;
+                } else {
+                        table->result[state] = 0;
+                }
+
+                // where does each card lead?
+                table->next[state][0] = state;
+                for (int m = ACE; m <= KING; ++m) {
+                        value = (m < 10) ? m : 10;
+                        if (hard + value > DEALER_MAX_HARD) {
+                                // bust whatever the aces
+                                table->next[state][m] =
+                                        DEALER_MAX_HARD * 2;
+                        } else {
+                                table->next[state][m] =
+                                        (hard + value) * 2 +
+                                        ((state % 2) || m == ACE);
+                        }
+                }
+        }
+} // build()
+
+
+
+static void build_all(void)
+{
+        build(&Tables[FALSE], FALSE);
+        build(&Tables[TRUE], TRUE);
+} // build_all()
+
+
+
+extern const struct dealer_table_t *dealer_table(int hit_soft_17)
+{
+        pthread_once(&Tables_once, build_all);
+
+        return &Tables[hit_soft_17 ? TRUE : FALSE];
+} // dealer_table()
+
+
+
+extern void dealer_odds_infinite(const struct dealer_table_t *table,
+                                 int state, const double prob[KING + 1],
+                                 double odds[DEALER_OUTCOMES])
+{
+        double all[DEALER_STATES][DEALER_OUTCOMES];
+        int s;
+
+        // Every card adds at least one to the hard total, so working
+        // down from the highest states only uses states already done.
+        memset(all, 0, sizeof(all));
+        for (s = DEALER_STATES - 1; s >= 0; --s) {
+                if (table->result[s] != 0) {
+                        all[s][table->result[s] - DRAW_SCORE - 1] = 1.0;
+                        continue;
+                }
+                for (int m = ACE; m <= KING; ++m) {
+                        for (int o = 0; o < DEALER_OUTCOMES; ++o) {
+                                all[s][o] += prob[m] *
+                                             all[table->next[s][m]][o];
+                        }
+                }
+        }
+        memcpy(odds, all[state], sizeof(all[state]));
+} // dealer_odds_infinite()
+
+
+
+// Add the odds from 'state' with 'counts' cards of each value left
+// (index 1..10; a ten-valued card is drawn as pattern 10), weighted by
+// 'weight'.
+static void odds_counts(const struct dealer_table_t *table, int state,
+                        unsigned short counts[11], int total,
+                        double weight, double odds[DEALER_OUTCOMES])
+{
+        if (table->result[state] != 0) {
+                odds[table->result[state] - DRAW_SCORE - 1] += weight;
+                return;
+        }
+        if (total == 0) {
+                // out of cards: cannot happen with a real shoe
+                return;
+        }
+        for (int v = ACE; v <= 10; ++v) {
+                if (counts[v] == 0) {
+                        continue;
+                }
+                double w = weight * counts[v] / total;
+                --counts[v];
+                odds_counts(table, table->next[state][v], counts, total - 1,
+                            w, odds);
+                ++counts[v];
+        }
+} // odds_counts()
+
+
+
+extern void dealer_odds_counts(const struct dealer_table_t *table,
+                               int state,
+                               const unsigned short counts[KING + 1],
+                               double odds[DEALER_OUTCOMES])
+{
+        unsigned short left[11];
+        int total = 0;
+
+        // the ten-valued patterns all lead to the same states
+        memset(left, 0, sizeof(left));
+        for (int m = ACE; m <= KING; ++m) {
+                left[(m < 10) ? m : 10] += counts[m];
+                total += counts[m];
+        }
+        memset(odds, 0, sizeof(double) * DEALER_OUTCOMES);
+        odds_counts(table, state, left, total, 1.0, odds);
+} // dealer_odds_counts()
+
+
+// end of dealer.c
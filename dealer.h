@@ -0,0 +1,82 @@
+// ----------------------------------------------------------------------
+// file: dealer.h
+//
+// Description: This is the header file for the DEALER module. It
+//     precomputes the dealer's play as tables over a compact hand state
+//     (hard total with aces as 1, and whether there is an ace), so that
+//     finishing the dealer's hand is a short walk through a table that
+//     fits in L1 cache instead of a score update and check per card:
+//         next[state][pattern]  state after drawing a card
+//         result[state]         0 while the dealer draws, else the final
+//                               total (17..21, or DEALER_BUST)
+//     It also computes the exact probabilities of the dealer's final
+//     totals for an infinite deck or a fixed composition.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef DEALER_H
+#define DEALER_H
+
+#include "card.h"
+#include "score.h"
+
+#define DEALER_MAX_HARD 26      // 16 plus a ten, the most the dealer holds
+#define DEALER_STATES ((DEALER_MAX_HARD + 1) * 2)
+#define DEALER_BUST (BEST_SCORE + 1)
+
+// Final outcomes for the odds: totals 17..21 then bust
+#define DEALER_OUTCOMES (DEALER_BUST - DRAW_SCORE)
+
+struct dealer_table_t {
+        unsigned char result[DEALER_STATES];
+        unsigned char next[DEALER_STATES][KING + 1];
+};
+
+
+// Return the (shared, read-only) table for a rule: the dealer hits a
+// soft 17 if 'hit_soft_17'. Safe to call from any thread.
+extern const struct dealer_table_t *dealer_table(int hit_soft_17);
+
+
+// Return the state of a dealer's hand.
+static inline int dealer_state(struct score_t score)
+{
+        int hard = score.tot_other + score.num_aces;
+
+        if (hard > DEALER_MAX_HARD) {
+                hard = DEALER_MAX_HARD;
+        }
+        return hard * 2 + (score.num_aces > 0);
+} // dealer_state()
+
+
+// Draw cards from 'shoe' until the dealer stands, starting from 'state',
+// and return the final total (DEALER_BUST if over BEST_SCORE).
+static inline int dealer_walk(const struct dealer_table_t *table,
+                              int state, struct shoe_t *shoe)
+{
+        while (table->result[state] == 0) {
+                state = table->next[state][CARD_PATTERN(shoe_deal(shoe))];
+        }
+        return table->result[state];
+} // dealer_walk()
+
+
+// Exact probabilities of the final outcomes (index total - 17, bust
+// last) from 'state' when every card is drawn with probability
+// prob[pattern] (an infinite deck).
+extern void dealer_odds_infinite(const struct dealer_table_t *table,
+                                 int state, const double prob[KING + 1],
+                                 double odds[DEALER_OUTCOMES]);
+
+
+// Exact probabilities of the final outcomes from 'state' when the cards
+// are drawn without replacement from counts[pattern] cards.
+extern void dealer_odds_counts(const struct dealer_table_t *table,
+                               int state,
+                               const unsigned short counts[KING + 1],
+                               double odds[DEALER_OUTCOMES]);
+
+#endif
+// end of dealer.h
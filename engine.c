@@ -0,0 +1,305 @@
+// ----------------------------------------------------------------------
+// file: engine.c
+//
+// Description: This file implements the ENGINE module. It instantiates
+//     engine_spec.h for the generic engine and for each specialized
+//     combination of rules and options, and picks between them.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include "common.h"
+#include "session.h"
+#include "dealer.h"
+#include "control.h"
+#include "engine.h"
+
+// Names of the functions generated from engine_spec.h
+#define SPEC_CAT2(a, b) a##_##b
+#define SPEC_CAT(a, b) SPEC_CAT2(a, b)
+#define SPEC_FN(suffix) SPEC_CAT(SPEC_NAME, suffix)
+
+// Payoff of a natural paid 3:2, in half bets
+#define PAYOFF_THREE_TO_TWO 3
+
+// Deal a card and add its term of the control variate: the value of the
+// hand after it (row[pattern]) times the cards left before the deal,
+// less the values after all those cards, times a weight of about
+// CONTROL_WEIGHT over the cards left. Returns the card's code.
+static unsigned char deal_term(struct shoe_t *shoe, const short *row,
+                               int *control)
+{
+        unsigned char code;
+        int sum = 0;
+        int left = 0;
+
+        // an empty shoe is shuffled first, so the card comes from it
+        if (shoe->next == shoe->num_cards) {
+                shoe_shuffle(shoe);
+        }
+        for (int m = ACE; m <= KING; ++m) {
+                sum += row[m] * shoe->left[m];
+                left += shoe->left[m];
+        }
+        code = shoe_deal(shoe);
+        *control += (row[CARD_PATTERN(code)] * left - sum) *
+                    ((CONTROL_WEIGHT + left / 2) / left);
+
+        return code;
+} // deal_term()
+
+
+
+// dealer_walk() that adds the term of each card the dealer draws, with
+// the values of the hand after it from each state in 'rows'.
+static int walk_control(const struct dealer_table_t *table, int state,
+                        struct shoe_t *shoe,
+                        const short rows[DEALER_STATES][KING + 1],
+                        int *control)
+{
+        unsigned char code;
+
+        while (table->result[state] == 0) {
+                code = deal_term(shoe, rows[state], control);
+                state = table->next[state][CARD_PATTERN(code)];
+        }
+        return table->result[state];
+} // walk_control()
+
+
+// The generic engine reads the rules and the options from the session.
+#define SPEC_NAME generic
+#define SPEC_NATURAL (session->rules.natural_payoff)
+#define SPEC_STRATEGY (strategy != NULL)
+#define SPEC_EXPORT (session->table != NULL)
+#define SPEC_SIDEBETS (session->sidebets != 0)
+#define SPEC_CONTROL (values != NULL)
+#include "engine_spec.h"
+
+// The common combinations: each natural payoff, with the dealer's or a
+// table strategy, and plain, exporting, with side bets or with the
+// control variate.
+#define SPEC_NAME even_dealer
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_table
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_dealer_export
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT TRUE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_table_export
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT TRUE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_dealer_side
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS TRUE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_table_side
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS TRUE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_dealer
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_table
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_dealer_export
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT TRUE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_table_export
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT TRUE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_dealer_side
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS TRUE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_table_side
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS TRUE
+#define SPEC_CONTROL FALSE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_dealer_control
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL TRUE
+#include "engine_spec.h"
+
+#define SPEC_NAME even_table_control
+#define SPEC_NATURAL PAYOFF_WIN
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL TRUE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_dealer_control
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY FALSE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL TRUE
+#include "engine_spec.h"
+
+#define SPEC_NAME three_to_two_table_control
+#define SPEC_NATURAL PAYOFF_THREE_TO_TWO
+#define SPEC_STRATEGY TRUE
+#define SPEC_EXPORT FALSE
+#define SPEC_SIDEBETS FALSE
+#define SPEC_CONTROL TRUE
+#include "engine_spec.h"
+
+
+// The specialized engines and what each one was built for. The dealer's
+// soft 17 rule is data (the dealer table), so both rules share one
+// engine.
+static const struct {
+        int natural_payoff;
+        int strategy;           // TRUE: a table strategy
+        int export;
+        int sidebets;
+        int control;
+        struct engine_t engine;
+} Specialized[] = {
+        { PAYOFF_WIN, FALSE, FALSE, FALSE, FALSE,
+          { "even_dealer", even_dealer_hand, even_dealer_run } },
+        { PAYOFF_WIN, TRUE, FALSE, FALSE, FALSE,
+          { "even_table", even_table_hand, even_table_run } },
+        { PAYOFF_WIN, FALSE, TRUE, FALSE, FALSE,
+          { "even_dealer_export", even_dealer_export_hand,
+            even_dealer_export_run } },
+        { PAYOFF_WIN, TRUE, TRUE, FALSE, FALSE,
+          { "even_table_export", even_table_export_hand,
+            even_table_export_run } },
+        { PAYOFF_WIN, FALSE, FALSE, TRUE, FALSE,
+          { "even_dealer_side", even_dealer_side_hand, even_dealer_side_run } },
+        { PAYOFF_WIN, TRUE, FALSE, TRUE, FALSE,
+          { "even_table_side", even_table_side_hand, even_table_side_run } },
+        { PAYOFF_THREE_TO_TWO, FALSE, FALSE, FALSE, FALSE,
+          { "three_to_two_dealer", three_to_two_dealer_hand,
+            three_to_two_dealer_run } },
+        { PAYOFF_THREE_TO_TWO, TRUE, FALSE, FALSE, FALSE,
+          { "three_to_two_table", three_to_two_table_hand,
+            three_to_two_table_run } },
+        { PAYOFF_THREE_TO_TWO, FALSE, TRUE, FALSE, FALSE,
+          { "three_to_two_dealer_export", three_to_two_dealer_export_hand,
+            three_to_two_dealer_export_run } },
+        { PAYOFF_THREE_TO_TWO, TRUE, TRUE, FALSE, FALSE,
+          { "three_to_two_table_export", three_to_two_table_export_hand,
+            three_to_two_table_export_run } },
+        { PAYOFF_THREE_TO_TWO, FALSE, FALSE, TRUE, FALSE,
+          { "three_to_two_dealer_side", three_to_two_dealer_side_hand,
+            three_to_two_dealer_side_run } },
+        { PAYOFF_THREE_TO_TWO, TRUE, FALSE, TRUE, FALSE,
+          { "three_to_two_table_side", three_to_two_table_side_hand,
+            three_to_two_table_side_run } },
+        { PAYOFF_WIN, FALSE, FALSE, FALSE, TRUE,
+          { "even_dealer_control", even_dealer_control_hand,
+            even_dealer_control_run } },
+        { PAYOFF_WIN, TRUE, FALSE, FALSE, TRUE,
+          { "even_table_control", even_table_control_hand,
+            even_table_control_run } },
+        { PAYOFF_THREE_TO_TWO, FALSE, FALSE, FALSE, TRUE,
+          { "three_to_two_dealer_control", three_to_two_dealer_control_hand,
+            three_to_two_dealer_control_run } },
+        { PAYOFF_THREE_TO_TWO, TRUE, FALSE, FALSE, TRUE,
+          { "three_to_two_table_control", three_to_two_table_control_hand,
+            three_to_two_table_control_run } },
+};
+
+static const struct engine_t Generic = {
+        "generic", generic_hand, generic_run
+};
+
+
+
+extern void rules_default(struct rules_t *rules)
+{
+        rules->hit_soft_17 = FALSE;
+        rules->natural_payoff = PAYOFF_WIN;
+} // rules_default()
+
+
+
+extern const struct engine_t *engine_select(
+        const struct session_t *session)
+{
+        const struct engine_t *engine = &Generic;
+        int n = sizeof(Specialized) / sizeof(Specialized[0]);
+
+        for (int i = 0; i < n; ++i) {
+                if (session->rules.natural_payoff ==
+                    Specialized[i].natural_payoff &&
+                    (session->strategy != NULL) == Specialized[i].strategy &&
+                    (session->table != NULL) == Specialized[i].export &&
+                    (session->sidebets != 0) == Specialized[i].sidebets &&
+                    (session->control_table != NULL) ==
+                    Specialized[i].control) {
+                        engine = &Specialized[i].engine;
+                        break;
+                }
+        }
+
+        return engine;
+} // engine_select()
+
+
+// end of engine.c
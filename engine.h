@@ -0,0 +1,57 @@
+// ----------------------------------------------------------------------
+// file: engine.h
+//
+// Description: This is the header file for the ENGINE module, which
+//     plays headless hands for sessions. The hand loop is written once
+//     (engine_spec.h) and compiled several times: once for each common
+//     combination of rules and options (the player's strategy, exported
+//     results, side bets), with them as constants so their tests fold
+//     away, and once generic, reading them at run time. engine_select()
+//     is the dispatcher that picks the variant for a session. The
+//     dealer's hand is finished with a walk through the session's
+//     dealer table (see dealer.h).
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdint.h>
+#include "stats.h"
+
+struct session_t;
+
+// Rules that change how a hand is played. (The number of decks belongs
+// to the shoe and does not change the hand loop.)
+struct rules_t {
+        int hit_soft_17;        // TRUE: the dealer hits a soft 17
+        int natural_payoff;     // half bets won with a natural
+};
+
+struct engine_t {
+        const char *name;
+
+        // Play one hand; returns the payoff in half bets.
+        int (*play_hand)(struct session_t *session);
+
+        // Play 'count' hands, recording each one in 'acc' and adding
+        // the payoffs and control values to *payoff and *control.
+        void (*play_run)(struct session_t *session, unsigned long long count,
+                         struct stats_acc_t *acc, int64_t *payoff,
+                         int64_t *control);
+};
+
+
+// Fill in the rules of the interactive game: the dealer stands on all
+// 17s and a natural wins even money.
+extern void rules_default(struct rules_t *rules);
+
+
+// Return the engine for the rules and options of a session: a
+// specialized one if there is one, otherwise the generic engine.
+extern const struct engine_t *engine_select(
+        const struct session_t *session);
+
+#endif
+// end of engine.h
@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------
+// file: engine_spec.h
+//
+// Description: This is the template for one engine variant. It has no
+//     include guard: engine.c includes it once per variant after
+//     defining
+//         SPEC_NAME      prefix of the generated functions
+//         SPEC_NATURAL   payoff of a natural
+//         SPEC_STRATEGY  TRUE: the player follows session->strategy;
+//                        FALSE: the player draws like the dealer
+//         SPEC_EXPORT    TRUE: results go to session->table too
+//         SPEC_SIDEBETS  TRUE: session->sidebets are settled
+//         SPEC_CONTROL   TRUE: session->control is added up from
+//                        session->control_table
+//     each a constant, or for the generic engine an expression of
+//     'session', and it undefines them again at the end. The dealer's
+//     rule needs no variant: it is built into the session's dealer
+//     table.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+
+// Deal a card, adding its term of the control variate from the values
+// in 'row' if the engine keeps one ('row' is not evaluated otherwise).
+#define SPEC_DEAL(row) \
+        (SPEC_CONTROL ? deal_term(shoe, (row), &session->control) : \
+         shoe_deal(shoe))
+
+static int SPEC_FN(hand)(struct session_t *session)
+{
+        struct shoe_t *shoe = &session->shoe;
+        struct score_t *player = &session->player;
+        struct score_t *dealer = &session->dealer;
+        const struct strategy_t *strategy = session->strategy;
+        const struct control_table_t *values = session->control_table;
+        unsigned char first;
+        unsigned char second;
+        unsigned char upcode;
+        unsigned char upcard;
+        unsigned char hole;
+        int up_value;
+        int start_row = 0;
+        int payoff;
+        int player_best;
+        int dealer_best;
+
+        session_reset_scores(session);
+        shoe_round(shoe);
+
+        // deal two cards each, player first
+        session->control = 0;
+        first = SPEC_DEAL(values->lead);
+        score_update(player, CARD_PATTERN(first));
+        upcode = SPEC_DEAL(values->up[control_value(CARD_PATTERN(first))]);
+        upcard = CARD_PATTERN(upcode);
+        up_value = control_value(upcard);
+        score_update(dealer, upcard);
+        second = SPEC_DEAL(values->second[control_value(CARD_PATTERN(first))]
+                                         [up_value]);
+        score_update(player, CARD_PATTERN(second));
+        hole = CARD_PATTERN(SPEC_DEAL(values->hole[control_hand(*player)]
+                                                  [up_value]));
+        score_update(dealer, hole);
+        if (SPEC_SIDEBETS) {
+                sidebet_record(session->sidebet_table, session->sidebets,
+                               first, second, upcode,
+                               score_best(*dealer) == BEST_SCORE,
+                               &session->side);
+        }
+        if (SPEC_EXPORT) {
+                start_row = strategy_row(*player);
+        }
+
+        if (score_best(*player) == BEST_SCORE) {
+                // natural: a draw only if the dealer has 21 as well
+                if (score_best(*dealer) == BEST_SCORE) {
+                        payoff = PAYOFF_DRAW;
+                } else {
+                        payoff = SPEC_NATURAL;
+                }
+        } else {
+                // player's turn
+                if (!(SPEC_STRATEGY)) {
+                        while (score_best(*player) <= DRAW_SCORE) {
+                                score_update(player, CARD_PATTERN(SPEC_DEAL(
+                                        values->hit[control_hand(*player)]
+                                                   [up_value]
+                                                   [control_value(hole)])));
+                        }
+                } else {
+                        int up = strategy_upcard(upcard);
+
+                        while (!score_isover(*player) &&
+                               strategy->action[strategy_row(*player)][up] ==
+                               STRATEGY_HIT) {
+                                score_update(player, CARD_PATTERN(SPEC_DEAL(
+                                        values->hit[control_hand(*player)]
+                                                   [up_value]
+                                                   [control_value(hole)])));
+                        }
+                }
+
+                if (score_isover(*player)) {
+                        payoff = PAYOFF_LOSS;
+                } else {
+                        // dealer's turn
+                        if (SPEC_CONTROL) {
+                                dealer_best = walk_control(
+                                        session->dealer_table,
+                                        dealer_state(*dealer), shoe,
+                                        values->dealer
+                                        [control_total(*player)],
+                                        &session->control);
+                        } else {
+                                dealer_best = dealer_walk(
+                                        session->dealer_table,
+                                        dealer_state(*dealer), shoe);
+                        }
+                        player_best = score_best(*player);
+                        if (dealer_best > BEST_SCORE ||
+                            player_best > dealer_best) {
+                                payoff = PAYOFF_WIN;
+                        } else if (player_best == dealer_best) {
+                                payoff = PAYOFF_DRAW;
+                        } else {
+                                payoff = PAYOFF_LOSS;
+                        }
+                }
+        }
+
+        // update the running results
+        ++session->hands;
+        if (payoff > 0) {
+                ++session->wins;
+        } else if (payoff < 0) {
+                ++session->losses;
+        } else {
+                ++session->draws;
+        }
+        if (SPEC_EXPORT) {
+                stats_table_add(session->table, start_row,
+                                strategy_upcard(upcard), payoff);
+        }
+
+        return payoff;
+} // hand()
+
+
+
+static void SPEC_FN(run)(struct session_t *session, unsigned long long count,
+                         struct stats_acc_t *acc, int64_t *payoff,
+                         int64_t *control)
+{
+        int p;
+
+        for (unsigned long long i = 0; i < count; ++i) {
+                p = SPEC_FN(hand)(session);
+                stats_acc_add(acc, p, session->control);
+                *payoff += p;
+                *control += session->control;
+        }
+} // run()
+
+
+#undef SPEC_NAME
+#undef SPEC_NATURAL
+#undef SPEC_STRATEGY
+#undef SPEC_EXPORT
+#undef SPEC_SIDEBETS
+#undef SPEC_CONTROL
+#undef SPEC_DEAL
+// end of engine_spec.h
@@ -0,0 +1,264 @@
+// ----------------------------------------------------------------------
+// file: equity.c
+//
+// Description: This file implements the EQUITY module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "common.h"
+#include "dealer.h"
+#include "equity.h"
+
+#define MAGIC "BJEQUITY"
+#define MAGIC_SIZE 8
+#define PATH_MAX_LEN 4096
+#define CARDS_PER_PATTERN 4.0   // in one deck
+#define HILO_SHIFT 0.1          // cards per pattern per point of count
+
+
+
+// Return TRUE if a pattern counts as low (+1) for Hi-Lo.
+static int is_low(int pattern)
+{
+        return pattern >= 2 && pattern <= 6;
+} // is_low()
+
+
+
+static int is_high(int pattern)
+{
+        return pattern == ACE || pattern >= 10;
+} // is_high()
+
+
+
+// The probability of each pattern at a true count.
+static void count_probs(int true_count, double prob[KING + 1])
+{
+        double shift = true_count * HILO_SHIFT;
+
+        prob[0] = 0;
+        for (int m = ACE; m <= KING; ++m) {
+                prob[m] = CARDS_PER_PATTERN;
+                if (is_low(m)) {
+                        prob[m] -= shift;
+                } else if (is_high(m)) {
+                        prob[m] += shift;
+                }
+                prob[m] /= CARDS_PER_DECK;
+        }
+} // count_probs()
+
+
+
+// Fill in the values of every hand against one up card.
+static void compute_upcard(const struct dealer_table_t *dealer,
+                           const double prob[KING + 1],
+                           unsigned char upcard,
+                           float ev[EQUITY_HANDS][2])
+{
+        double odds[DEALER_OUTCOMES];
+        double best_ev[EQUITY_HANDS];
+        struct score_t up = { 0, 0 };
+        double bust;
+
+        score_update(&up, upcard);
+        dealer_odds_infinite(dealer, dealer_state(up), prob, odds);
+        bust = odds[DEALER_OUTCOMES - 1];
+
+        // a hit only raises the hard total, so go down from 21
+        for (int hard = BEST_SCORE; hard >= 0; --hard) {
+                for (int ace = 1; ace >= 0; --ace) {
+                        int hand = hard * 2 + ace;
+                        int best = hard;
+                        double stand = bust;
+                        double hit = 0;
+
+                        if (ace && hard + HIGH_ACE - LOW_ACE <= BEST_SCORE) {
+                                best = hard + HIGH_ACE - LOW_ACE;
+                        }
+                        for (int t = 0; t < DEALER_OUTCOMES - 1; ++t) {
+                                int total = DRAW_SCORE + 1 + t;
+                                if (total < best) {
+                                        stand += odds[t];
+                                } else if (total > best) {
+                                        stand -= odds[t];
+                                }
+                        }
+
+                        for (int m = ACE; m <= KING; ++m) {
+                                int next = hard + (m < 10 ? m : 10);
+                                if (next > BEST_SCORE) {
+                                        hit -= prob[m];
+                                } else {
+                                        hit += prob[m] *
+                                               best_ev[next * 2 +
+                                                       (ace || m == ACE)];
+                                }
+                        }
+
+                        ev[hand][EQUITY_STAND] = stand;
+                        ev[hand][EQUITY_HIT] = hit;
+                        best_ev[hand] = stand > hit ? stand : hit;
+                }
+        }
+} // compute_upcard()
+
+
+
+extern void equity_compute(struct equity_table_t *table, int hit_soft_17)
+{
+        const struct dealer_table_t *dealer = dealer_table(hit_soft_17);
+        double prob[KING + 1];
+
+        memset(&table->header, 0, sizeof(table->header));
+        memcpy(table->header.magic, MAGIC, MAGIC_SIZE);
+        table->header.version = EQUITY_VERSION;
+        table->header.header_size = sizeof(table->header);
+        table->header.tc_min = EQUITY_TC_MIN;
+        table->header.num_tc = EQUITY_TC_BUCKETS;
+        table->header.num_upcards = STRATEGY_UPCARDS;
+        table->header.num_hands = EQUITY_HANDS;
+        table->header.hit_soft_17 = hit_soft_17 ? TRUE : FALSE;
+
+        for (int b = 0; b < EQUITY_TC_BUCKETS; ++b) {
+                count_probs(EQUITY_TC_MIN + b, prob);
+                for (int m = ACE; m <= 10; ++m) {
+                        compute_upcard(dealer, prob, m,
+                                       table->ev[b][strategy_upcard(m)]);
+                }
+        }
+} // equity_compute()
+
+
+
+extern int equity_save(const char *path, const struct equity_table_t *table)
+{
+        char tmp_path[PATH_MAX_LEN];
+        FILE *out;
+        int result = SUCCESS;
+
+        if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp",
+                     path) >= (int)sizeof(tmp_path)) {
+                errno = ENAMETOOLONG;
+                return -1;
+        }
+        out = fopen(tmp_path, "wb");
+        if (out == NULL) {
+                return -1;
+        }
+        if (fwrite(table, sizeof(*table), 1, out) != 1) {
+                result = -1;
+        }
+        if (fclose(out) != 0) {
+                result = -1;
+        }
+
+        if (result == SUCCESS) {
+                result = rename(tmp_path, path) == 0 ? SUCCESS : -1;
+        } else {
+                remove(tmp_path);
+        }
+
+        return result;
+} // equity_save()
+
+
+
+extern int equity_open(struct equity_t *equity, const char *path,
+                       int hit_soft_17)
+{
+        const struct equity_header_t *header;
+        struct stat info;
+        void *map;
+        int fd;
+
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                return -1;
+        }
+        if (fstat(fd, &info) != 0) {
+                close(fd);
+                return -1;
+        }
+        if (info.st_size != sizeof(struct equity_table_t)) {
+                close(fd);
+                errno = EINVAL;
+                return -1;
+        }
+        map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+                return -1;
+        }
+
+        header = map;
+        if (memcmp(header->magic, MAGIC, MAGIC_SIZE) != 0 ||
+            header->version != EQUITY_VERSION ||
+            header->header_size != sizeof(*header) ||
+            header->tc_min != EQUITY_TC_MIN ||
+            header->num_tc != EQUITY_TC_BUCKETS ||
+            header->num_upcards != STRATEGY_UPCARDS ||
+            header->num_hands != EQUITY_HANDS ||
+            header->hit_soft_17 != (hit_soft_17 ? TRUE : FALSE)) {
+                munmap(map, info.st_size);
+                errno = EINVAL;
+                return -1;
+        }
+        equity->table = map;
+        equity->size = info.st_size;
+
+        return SUCCESS;
+} // equity_open()
+
+
+
+extern void equity_close(struct equity_t *equity)
+{
+        munmap((void *)equity->table, equity->size);
+        equity->table = NULL;
+} // equity_close()
+
+
+
+extern int equity_true_count(const struct shoe_t *shoe,
+                             unsigned char hidden)
+{
+        int running = 0;
+        int unseen = hidden != 0;
+        int true_count;
+
+        for (int m = ACE; m <= KING; ++m) {
+                int seen = shoe->full[m] - shoe->left[m] - (m == hidden);
+                if (is_low(m)) {
+                        running += seen;
+                } else if (is_high(m)) {
+                        running -= seen;
+                }
+                unseen += shoe->left[m];
+        }
+        if (unseen == 0) {
+                return 0;
+        }
+
+        true_count = lround(running * (double)CARDS_PER_DECK / unseen);
+        if (true_count < EQUITY_TC_MIN) {
+                true_count = EQUITY_TC_MIN;
+        } else if (true_count > EQUITY_TC_MAX) {
+                true_count = EQUITY_TC_MAX;
+        }
+
+        return true_count;
+} // equity_true_count()
+
+
+// end of equity.c
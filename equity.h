@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------
+// file: equity.h
+//
+// Description: This is the header file for the EQUITY module. It holds
+//     tables of the expected value of standing and of hitting (and then
+//     playing on perfectly) for every player hand, dealer up card and
+//     true count, under the rules of the interactive game. The tables
+//     are computed offline by mkequity and written to a binary file,
+//     which the game maps into memory at startup: hints cost a lookup,
+//     with no warm-up, and every process using the file shares its
+//     pages.
+//
+//     The values are exact for an infinite deck whose composition is
+//     shifted by the true count (Hi-Lo: each point moves a tenth of a
+//     card per deck from every low pattern, 2..6, to every high one, ten
+//     to ace). With an infinite deck a hand's value depends on its cards
+//     only through its hard total and whether it holds an ace, so that
+//     pair is the hand's index (as in the dealer tables).
+//
+//     File layout (native byte order): an equity_header_t, then the
+//     values as floats, ev[count][up card][hand][EQUITY_STAND or
+//     EQUITY_HIT], in units of one bet.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "card.h"
+#include "score.h"
+#include "strategy.h"
+
+#define EQUITY_VERSION 1
+#define EQUITY_TC_MIN (-6)
+#define EQUITY_TC_MAX 6
+#define EQUITY_TC_BUCKETS (EQUITY_TC_MAX - EQUITY_TC_MIN + 1)
+#define EQUITY_HANDS ((BEST_SCORE + 1) * 2)     // hard 0..21, ace or not
+
+#define EQUITY_STAND 0
+#define EQUITY_HIT 1
+
+struct equity_header_t {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        int32_t tc_min;
+        uint32_t num_tc;
+        uint32_t num_upcards;
+        uint32_t num_hands;
+        uint32_t hit_soft_17;
+        uint32_t reserved;
+};
+
+struct equity_table_t {
+        struct equity_header_t header;
+        float ev[EQUITY_TC_BUCKETS][STRATEGY_UPCARDS][EQUITY_HANDS][2];
+};
+
+// A table mapped from a file
+struct equity_t {
+        const struct equity_table_t *table;
+        size_t size;
+};
+
+
+// Compute every value for a dealer rule.
+extern void equity_compute(struct equity_table_t *table, int hit_soft_17);
+
+
+// Write a table to 'path' (through "<path>.tmp", renamed when complete).
+// Returns SUCCESS or -1.
+extern int equity_save(const char *path, const struct equity_table_t *table);
+
+
+// Map the table in 'path' read-only. 'hit_soft_17' is the dealer rule
+// of the game it is for. Returns SUCCESS, or -1 if the file cannot be
+// mapped or is not a table of this version for that rule (errno
+// EINVAL).
+extern int equity_open(struct equity_t *equity, const char *path,
+                       int hit_soft_17);
+
+
+// Unmap a table.
+extern void equity_close(struct equity_t *equity);
+
+
+// Return the Hi-Lo true count, rounded and clipped to the table, of the
+// cards the player has not seen: those left in 'shoe' and the dealer's
+// hole card (pattern 'hidden', 0 if none).
+extern int equity_true_count(const struct shoe_t *shoe,
+                             unsigned char hidden);
+
+
+// Return the values (indexed by EQUITY_STAND and EQUITY_HIT) of a hand
+// that is not over BEST_SCORE against an up card at a true count.
+static inline const float *equity_lookup(const struct equity_t *equity,
+                                         int true_count,
+                                         unsigned char upcard,
+                                         struct score_t score)
+{
+        int hand = (score.tot_other + score.num_aces) * 2 +
+                   (score.num_aces > 0);
+
+        return equity->table->ev[true_count - EQUITY_TC_MIN]
+                                [strategy_upcard(upcard)][hand];
+} // equity_lookup()
+
+#endif
+// end of equity.h
@@ -0,0 +1,242 @@
+// ----------------------------------------------------------------------
+// file: export.c
+//
+// Description: This file implements the EXPORT module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include "common.h"
+#include "strategy.h"
+#include "export.h"
+
+#define FILE_BUFFER_SIZE (1 << 16)
+
+
+
+// Write one line of CSV for the totals in 'stats'.
+static void write_csv(FILE *out, const struct export_record_t *record,
+                      const char *hand, const char *upcard,
+                      const struct stats_t *stats)
+{
+        fprintf(out, "%llu,%d,%s,%s,%llu,%llu,%llu,%llu,%.6f,%.6f\n",
+                record->batch, record->strategy + 1, hand, upcard,
+                (unsigned long long)stats->hands,
+                (unsigned long long)stats->wins,
+                (unsigned long long)stats->losses,
+                (unsigned long long)stats->draws,
+                stats_ev(stats), stats_variance(stats));
+} // write_csv()
+
+
+
+// Write the JSON members for the totals in 'stats'.
+static void write_json_totals(FILE *out, const struct stats_t *stats)
+{
+        fprintf(out, "\"hands\":%llu,\"wins\":%llu,\"losses\":%llu,"
+                "\"draws\":%llu,\"ev\":%.6f,\"variance\":%.6f",
+                (unsigned long long)stats->hands,
+                (unsigned long long)stats->wins,
+                (unsigned long long)stats->losses,
+                (unsigned long long)stats->draws,
+                stats_ev(stats), stats_variance(stats));
+} // write_json_totals()
+
+
+
+static void write_record(struct export_t *export,
+                         const struct export_record_t *record)
+{
+        FILE *out = export->file;
+        struct stats_t stats;
+        char hand[STRATEGY_NAME_SIZE];
+        char upcard[2] = { 0, 0 };
+        const char *sep = "";
+
+        stats_table_get(&record->table, -1, 0, &stats);
+        if (export->format == EXPORT_JSON) {
+                fprintf(out, "{\"batch\":%llu,\"strategy\":%d,",
+                        record->batch, record->strategy + 1);
+                write_json_totals(out, &stats);
+                fprintf(out, ",\"cells\":[");
+        } else {
+                write_csv(out, record, "all", "all", &stats);
+        }
+
+        for (int row = 0; row < STRATEGY_ROWS; ++row) {
+                strategy_row_name(row, hand);
+                for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                        if (record->table.cell[row][up].hands == 0) {
+                                continue;
+                        }
+                        stats_table_get(&record->table, row, up, &stats);
+                        upcard[0] = strategy_upcard_name(up);
+                        if (export->format == EXPORT_JSON) {
+                                fprintf(out, "%s{\"hand\":\"%s\","
+                                        "\"upcard\":\"%s\",", sep, hand,
+                                        upcard);
+                                write_json_totals(out, &stats);
+                                fprintf(out, "}");
+                                sep = ",";
+                        } else {
+                                write_csv(out, record, hand, upcard, &stats);
+                        }
+                }
+        }
+
+        if (export->format == EXPORT_JSON) {
+                fprintf(out, "]}\n");
+        }
+} // write_record()
+
+
+
+static void *writer_main(void *arg)
+{
+        struct export_t *export = arg;
+        const struct export_record_t *records;
+        int num;
+
+        pthread_mutex_lock(&export->lock);
+        for (;;) {
+                while (export->num_pending == 0 && !export->closing) {
+                        pthread_cond_wait(&export->pending, &export->lock);
+                }
+                if (export->num_pending == 0) {
+                        // closing: take what is left, if anything
+                        if (export->num_filled == 0) {
+                                break;
+                        }
+                        export->num_pending = export->num_filled;
+                        export->num_filled = 0;
+                        export->filling = !export->filling;
+                }
+
+                // the workers fill the other buffer meanwhile
+                records = export->buffers[!export->filling];
+                num = export->num_pending;
+                pthread_mutex_unlock(&export->lock);
+                for (int i = 0; i < num; ++i) {
+                        write_record(export, &records[i]);
+                }
+                pthread_mutex_lock(&export->lock);
+
+                // take the next buffer at once if there is one
+                export->num_pending = export->num_filled;
+                if (export->num_filled > 0) {
+                        export->num_filled = 0;
+                        export->filling = !export->filling;
+                }
+                pthread_cond_broadcast(&export->drained);
+        }
+        pthread_mutex_unlock(&export->lock);
+
+        return NULL;
+} // writer_main()
+
+
+
+extern int export_open(struct export_t *export, const char *path,
+                       int format)
+{
+        size_t size = sizeof(struct export_record_t) * EXPORT_BUFFER_RECORDS;
+
+        if (format != EXPORT_CSV && format != EXPORT_JSON) {
+                return -1;
+        }
+        if (arena_init(&export->arena, 2 * size + ARENA_ALIGN) != SUCCESS) {
+                return -1;
+        }
+        export->buffers[0] = arena_alloc(&export->arena, size);
+        export->buffers[1] = arena_alloc(&export->arena, size);
+
+        if (strcmp(path, "-") == 0) {
+                export->file = stdout;
+        } else {
+                export->file = fopen(path, "w");
+        }
+        if (export->file == NULL) {
+                arena_free(&export->arena);
+                return -1;
+        }
+        setvbuf(export->file, NULL, _IOFBF, FILE_BUFFER_SIZE);
+
+        export->format = format;
+        export->filling = 0;
+        export->num_filled = 0;
+        export->num_pending = 0;
+        export->closing = FALSE;
+        pthread_mutex_init(&export->lock, NULL);
+        pthread_cond_init(&export->pending, NULL);
+        pthread_cond_init(&export->drained, NULL);
+
+        if (format == EXPORT_CSV) {
+                fprintf(export->file, "batch,strategy,hand,upcard,hands,"
+                        "wins,losses,draws,ev,variance\n");
+        }
+        if (pthread_create(&export->writer, NULL, writer_main,
+                           export) != 0) {
+                if (export->file != stdout) {
+                        fclose(export->file);
+                }
+                arena_free(&export->arena);
+                return -1;
+        }
+
+        return SUCCESS;
+} // export_open()
+
+
+
+extern void export_submit(struct export_t *export,
+                          const struct export_record_t *record)
+{
+        pthread_mutex_lock(&export->lock);
+        while (export->num_filled == EXPORT_BUFFER_RECORDS) {
+                // the writer is a whole buffer behind
+                pthread_cond_wait(&export->drained, &export->lock);
+        }
+        memcpy(&export->buffers[export->filling][export->num_filled],
+               record, sizeof(*record));
+        ++export->num_filled;
+
+        if (export->num_pending == 0) {
+                // the writer is idle: hand it this buffer now
+                export->num_pending = export->num_filled;
+                export->num_filled = 0;
+                export->filling = !export->filling;
+                pthread_cond_signal(&export->pending);
+        }
+        pthread_mutex_unlock(&export->lock);
+} // export_submit()
+
+
+
+extern int export_close(struct export_t *export)
+{
+        int result = SUCCESS;
+
+        pthread_mutex_lock(&export->lock);
+        export->closing = TRUE;
+        pthread_cond_signal(&export->pending);
+        pthread_mutex_unlock(&export->lock);
+        pthread_join(export->writer, NULL);
+
+        if (ferror(export->file) || fflush(export->file) != 0) {
+                result = -1;
+        }
+        if (export->file != stdout && fclose(export->file) != 0) {
+                result = -1;
+        }
+        pthread_mutex_destroy(&export->lock);
+        pthread_cond_destroy(&export->pending);
+        pthread_cond_destroy(&export->drained);
+        arena_free(&export->arena);
+
+        return result;
+} // export_close()
+
+
+// end of export.c
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------
+// file: export.h
+//
+// Description: This is the header file for the EXPORT module. It
+//     streams the results of every simulated batch to a file as CSV or
+//     JSON lines.
+//
+//     Simulation workers hand over raw records (the batch's stats table)
+//     and a background writer thread formats and writes them, so the
+//     workers never wait for formatting or I/O. Records go into one of
+//     two buffers while the writer drains the other; whenever the writer
+//     is idle it takes the buffer being filled. A worker only waits if
+//     the writer is a whole buffer behind.
+//
+//     CSV has one line per starting hand and up card that was played in
+//     the batch and one line with the batch totals ("all,all"):
+//         batch,strategy,hand,upcard,hands,wins,losses,draws,ev,variance
+//     JSON has one object per batch and strategy with the totals and a
+//     "cells" array of the same breakdown. Batches are written in the
+//     order they finish, which depends on the threads.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "arena.h"
+#include "stats.h"
+
+#define EXPORT_CSV 0
+#define EXPORT_JSON 1
+
+#define EXPORT_BUFFER_RECORDS 64
+
+// The results of one strategy in one batch.
+struct export_record_t {
+        unsigned long long batch;
+        int strategy;
+        struct stats_table_t table;
+};
+
+struct export_t {
+        FILE *file;
+        int format;                         // EXPORT_ value
+        struct arena_t arena;               // holds the two buffers
+        struct export_record_t *buffers[2];
+        int filling;                        // buffer the workers fill
+        int num_filled;                     // ...records in it
+        int num_pending;                    // records in the other (0 if
+                                            // the writer is idle)
+        int closing;
+        pthread_mutex_t lock;
+        pthread_cond_t pending;             // the writer has work
+        pthread_cond_t drained;             // the writer went idle
+        pthread_t writer;
+};
+
+
+// Open 'path' ("-" for the standard output) and start the writer.
+// Returns SUCCESS or -1.
+extern int export_open(struct export_t *export, const char *path,
+                       int format);
+
+
+// Queue a copy of a record for writing. Safe to call from any thread.
+extern void export_submit(struct export_t *export,
+                          const struct export_record_t *record);
+
+
+// Write everything queued, stop the writer and close the file. Returns
+// SUCCESS, or -1 if anything could not be written.
+extern int export_close(struct export_t *export);
+
+#endif
+// end of export.h
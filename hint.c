@@ -0,0 +1,239 @@
+// ----------------------------------------------------------------------
+// file: hint.c
+//
+// Description: This file implements the HINT module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <math.h>
+#include "common.h"
+#include "table.h"
+#include "hint.h"
+
+#define HINT_LINE 1             // the line under the equity hint
+#define HINT_SIZE 64
+
+
+
+// Basic strategy for the cards after the first hit: TRUE to hit again.
+static int hit_again(struct score_t player, unsigned char upcard)
+{
+        int best = score_best(player);
+        int strong = upcard == ACE || upcard >= 7;
+
+        if (best != player.tot_other + player.num_aces) {
+                // soft
+                return best <= DRAW_SCORE + 1;
+        }
+        return best <= 11 || (best <= DRAW_SCORE && strong) ||
+               (best == 12 && upcard <= 3);
+} // hit_again()
+
+
+
+// Return the card at 'pos' of this trial's order of the unseen cards,
+// drawing the order as far as needed (*drawn cards are drawn), or 0 if
+// there are not that many cards.
+static unsigned char card_at(struct hint_t *hint, int *drawn, int pos)
+{
+        unsigned char *cards = hint->unseen;
+
+        if (pos >= hint->num_unseen) {
+                return 0;
+        }
+        while (*drawn <= pos) {
+                // one step of Fisher-Yates
+                int j = *drawn + rng_below(&hint->rng,
+                                           hint->num_unseen - *drawn);
+                unsigned char pattern = cards[j];
+                cards[j] = cards[*drawn];
+                cards[(*drawn)++] = pattern;
+        }
+
+        return cards[pos];
+} // card_at()
+
+
+
+// Finish the dealer's hand from card 'pos' on; returns the total
+// (DEALER_BUST if over), or 0 if the cards ran out.
+static int dealer_total(struct hint_t *hint, int *drawn, int pos)
+{
+        struct score_t up = { 0, 0 };
+        int state;
+
+        score_update(&up, hint->upcard);
+        state = dealer_state(up);
+        while (hint->dealer->result[state] == 0) {
+                unsigned char pattern = card_at(hint, drawn, pos++);
+                if (pattern == 0) {
+                        return 0;
+                }
+                state = hint->dealer->next[state][pattern];
+        }
+
+        return hint->dealer->result[state];
+} // dealer_total()
+
+
+
+// The payoff in bets of a standing player against the dealer's total.
+static int settle(int player_best, int dealer)
+{
+        if (dealer > BEST_SCORE || player_best > dealer) {
+                return 1;
+        }
+        return player_best == dealer ? 0 : -1;
+} // settle()
+
+
+
+// Play one trial. Returns FALSE if the unseen cards ran out.
+static int play_trial(struct hint_t *hint)
+{
+        struct score_t player = hint->player;
+        int drawn = 0;
+        int pos = 0;
+        int dealer;
+        int stand;
+        int hit;
+
+        // standing: the dealer takes the cards in order
+        dealer = dealer_total(hint, &drawn, 0);
+        if (dealer == 0) {
+                return FALSE;
+        }
+        stand = settle(score_best(player), dealer);
+
+        // hitting: the player takes the first cards
+        do {
+                unsigned char pattern = card_at(hint, &drawn, pos++);
+                if (pattern == 0) {
+                        return FALSE;
+                }
+                score_update(&player, pattern);
+        } while (!score_isover(player) && hit_again(player, hint->upcard));
+        if (score_isover(player)) {
+                hit = -1;
+        } else {
+                dealer = dealer_total(hint, &drawn, pos);
+                if (dealer == 0) {
+                        return FALSE;
+                }
+                hit = settle(score_best(player), dealer);
+        }
+
+        ++hint->trials;
+        hint->stand += stand;
+        hint->hit += hit;
+        hint->diff_squares += (hit - stand) * (hit - stand);
+
+        return TRUE;
+} // play_trial()
+
+
+
+static void report(const struct hint_t *hint)
+{
+        char text[HINT_SIZE];
+        double n = hint->trials;
+        double stand = hint->stand / n;
+        double hit = hint->hit / n;
+        double diff = hit - stand;
+        double variance = hint->diff_squares / n - diff * diff;
+        double error;
+
+        // rounding can leave a tiny negative variance when the
+        // differences are almost all the same
+        if (variance < 0) {
+                variance = 0;
+        }
+        error = sqrt(variance / n);
+
+        // the standard error of the difference in brackets
+        snprintf(text, sizeof(text), "Sim %llu: stand %+.3f, hit %+.3f "
+                 "(%.3f) %s", hint->trials, stand, hit, error,
+                 hit > stand ? "HIT" : "STAND");
+        table_hint(HINT_LINE, text);
+} // report()
+
+
+
+extern void hint_init(struct hint_t *hint, uint64_t seed)
+{
+        rng_seed(&hint->rng, seed);
+        hint->dealer = dealer_table(FALSE);
+        hint->active = FALSE;
+} // hint_init()
+
+
+
+extern void hint_start(struct hint_t *hint, const struct shoe_t *shoe,
+                       unsigned char hidden, unsigned char upcard,
+                       struct score_t player)
+{
+        int n = 0;
+
+        for (int m = ACE; m <= KING; ++m) {
+                for (int i = 0; i < shoe->left[m]; ++i) {
+                        hint->unseen[n++] = m;
+                }
+        }
+        if (hidden != 0 && n < MAX_SHOE_CARDS) {
+                hint->unseen[n++] = hidden;
+        }
+        hint->num_unseen = n;
+        hint->upcard = upcard;
+        hint->player = player;
+        hint->trials = 0;
+        hint->stand = 0;
+        hint->hit = 0;
+        hint->diff_squares = 0;
+        hint->next_report = HINT_FIRST_REPORT;
+        hint->active = TRUE;
+
+        // the last report was about another decision
+        table_hint(HINT_LINE, "");
+} // hint_start()
+
+
+
+extern void hint_stop(struct hint_t *hint)
+{
+        hint->active = FALSE;
+} // hint_stop()
+
+
+
+extern int hint_idle(void *arg)
+{
+        struct hint_t *hint = arg;
+
+        if (!hint->active) {
+                return FALSE;
+        }
+        for (int i = 0; i < HINT_SLICE_TRIALS; ++i) {
+                if (!play_trial(hint)) {
+                        // too few cards left to play the hand out
+                        table_hint(HINT_LINE, "too few cards to simulate");
+                        hint->active = FALSE;
+                        return FALSE;
+                }
+        }
+
+        if (hint->trials >= hint->next_report ||
+            hint->trials >= HINT_MAX_TRIALS) {
+                report(hint);
+                hint->next_report *= 2;
+        }
+        if (hint->trials >= HINT_MAX_TRIALS) {
+                hint->active = FALSE;
+        }
+
+        return hint->active;
+} // hint_idle()
+
+
+// end of hint.c
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------
+// file: hint.h
+//
+// Description: This is the header file for the HINT module. While the
+//     interactive game waits for the player to hit or stand, it plays
+//     the rest of the hand out many times from the cards the player has
+//     not seen (those left in the shoe and the dealer's hole card) and
+//     shows the estimated value of standing and of hitting.
+//
+//     The work is done on the game thread in small slices by
+//     hint_idle(), which the TABLE module calls while no key is waiting
+//     (see table_set_idle()), so a key is never kept waiting for more
+//     than one slice. The estimate is redrawn as it improves and the
+//     work stops after HINT_MAX_TRIALS hands.
+//
+//     Each trial deals the unseen cards in a random order to both plays
+//     (common random numbers): standing gives them all to the dealer;
+//     hitting gives the first to the player, who then plays on with a
+//     simple basic strategy, and the rest to the dealer.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef HINT_H
+#define HINT_H
+
+#include <stdint.h>
+#include "rng.h"
+#include "card.h"
+#include "score.h"
+#include "dealer.h"
+
+#define HINT_SLICE_TRIALS 500
+#define HINT_FIRST_REPORT 2000
+#define HINT_MAX_TRIALS 500000
+
+struct hint_t {
+        struct rng_t rng;
+        const struct dealer_table_t *dealer;
+        int active;
+        unsigned char upcard;
+        struct score_t player;
+        unsigned char unseen[MAX_SHOE_CARDS];   // patterns
+        int num_unseen;
+        unsigned long long trials;
+        long long stand;                // total payoffs (in bets)
+        long long hit;
+        double diff_squares;            // sum of (hit - stand)^2
+        unsigned long long next_report; // trials at the next redraw
+};
+
+
+// Set up the hint engine for a game whose dealer stands on soft 17.
+extern void hint_init(struct hint_t *hint, uint64_t seed);
+
+
+// Start estimating the player's hand against 'upcard', from the cards
+// left in 'shoe' and the hole card (pattern 'hidden'), and clear the
+// report on the previous decision.
+extern void hint_start(struct hint_t *hint, const struct shoe_t *shoe,
+                       unsigned char hidden, unsigned char upcard,
+                       struct score_t player);
+
+
+// Stop estimating (the player has decided).
+extern void hint_stop(struct hint_t *hint);
+
+
+// Do one slice of work; 'arg' is the hint_t. Returns TRUE if there is
+// more to do. Suitable for table_set_idle().
+extern int hint_idle(void *arg);
+
+#endif
+// end of hint.h
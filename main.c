@@ -14,32 +14,55 @@
 //     Registered an exit handler so things get cleaned up properly.
 // 2016-10-26  (P. Clark)
 //     Added 'static' to internal functions.
+// 2026-10-18
+//     Moved the scoring functions to the SCORE module and the scores
+//     and deck into a session object allocated from an arena.
+//     Added the -b option to broadcast the game to spectators.
+//     Added the -f option to play a script of keys without a terminal,
+//     and -s to seed the shoe.
+//     Added the -e option to show hints from an equity table.
+//     Added the -H option to estimate the hand by simulation while the
+//     player decides.
+//     Added the -p option to place side bets on every hand.
 // ----------------------------------------------------------------------
 #include <stdio.h>
 #include <termios.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/times.h>
 #include "common.h"
 #include "table.h"
 #include "card.h"
+#include "arena.h"
+#include "session.h"
+#include "broadcast.h"
+#include "equity.h"
+#include "hint.h"
+#include "sidebet.h"
 
+#define HINT_SIZE 64
+#define HINT_STREAM 1          // the simulation's stream of the seed
+#define SIDE_SIZE 80
 
-#define DRAW_SCORE 16
-#define BEST_SCORE 21
-#define LOW_ACE 1
-#define HIGH_ACE 11
 
-
-// new type for keeping score of current hand for player and dealer
-struct score_t {
-        unsigned char num_aces;
-        unsigned char tot_other;
-};
-static struct score_t Player_score;
-static struct score_t Dealer_score;
+static struct arena_t Arena;       // holds the session
+static struct session_t *Session;  // shoe and scores for this game
 static struct termios Old_trm; // original terminal settings
 static int Changed = FALSE;    // were terminal settings changed?
+static struct broadcast_t Broadcast;  // spectators (with -b)
+static int Broadcasting = FALSE;
+static struct equity_t Equity;        // hints (with -e)
+static int Hinting = FALSE;
+static unsigned char Upcard;          // dealer's cards in this hand
+static unsigned char Hole_card;
+static struct hint_t Hint;            // simulated hints (with -H)
+static int Simulating = FALSE;
+static int Sidebets = 0;              // mask of side bets (with -p)
+static long long Side_total;          // ...won over the game, in bets
+static int Scripted = FALSE;
 
 
 
@@ -51,65 +74,58 @@ static void when_exiting(void) {
         }
         // clean up
         table_exit();
-} // when_exiting()
-
-
-
-static int best_score(struct score_t score)
-{
-        int tot;
-
-        // First calc the lowest possible score
-        tot = score.tot_other + score.num_aces;
-
-        // Now see if we can improve the score by replacing one of the
-        // aces with an '11'. We can obviously only do that once or we
-        // automatically go over.
-        if (score.num_aces > 0) {
-                if ((tot - LOW_ACE + HIGH_ACE) <= BEST_SCORE) {
-                        tot = tot - LOW_ACE + HIGH_ACE;
-                }
+        if (Sidebets != 0 && Scripted) {
+                printf("side bets %+lld\n", Side_total);
+                Sidebets = 0;
         }
-
-        return tot;
-} // best_score()
+        if (Broadcasting) {
+                table_set_broadcast(NULL);
+                broadcast_stop(&Broadcast);
+        }
+        if (Hinting) {
+                equity_close(&Equity);
+        }
+        arena_free(&Arena);
+} // when_exiting()
 
 
 
-static unsigned char isover(struct score_t score)
+// Deal the next card from the session's shoe.
+static void deal(unsigned char *suit, unsigned char *pattern)
 {
-        unsigned char result;
+        unsigned char code = shoe_deal(&Session->shoe);
 
-        if (best_score(score) > BEST_SCORE) {
-                result = TRUE;
-        }  else {
-                result = FALSE;
-        }
+        *suit = CARD_SUIT(code);
+        *pattern = CARD_PATTERN(code);
+} // deal()
 
-        return result;
-} // isover()
 
 
-
-static void update_score(struct score_t *score, unsigned char pattern)
+// Settle the side bets on the first cards and show the results.
+static void settle_side_bets(const unsigned char player[2],
+                             unsigned char upcard)
 {
-        if (pattern > ACE && pattern < JACK) {
-                score->tot_other = score->tot_other + pattern;
-        } else if (pattern == ACE) {
-                score->num_aces = score->num_aces + 1;
-        } else {
-                // face card
-                score->tot_other = score->tot_other + 10;
+        char text[SIDE_SIZE];
+        int payoff[SIDEBET_KINDS];
+        const char *separator = " ";
+        int len;
+
+        sidebet_score(sidebet_table(), player[0], player[1], upcard,
+                      score_best(Session->dealer) == BEST_SCORE, payoff);
+        len = snprintf(text, sizeof(text), "Side bets:");
+        for (int k = 0; k < SIDEBET_KINDS; ++k) {
+                if (Sidebets & (1 << k)) {
+                        Side_total += payoff[k];
+                        len += snprintf(text + len, sizeof(text) - len,
+                                        "%s%s %+d", separator,
+                                        sidebet_name(k), payoff[k]);
+                        separator = ", ";
+                }
         }
-} // update_score()
-
-
-
-static void reset_scores(void)
-{
-        Player_score.num_aces  = Dealer_score.num_aces  = 0;
-        Player_score.tot_other = Dealer_score.tot_other = 0;
-} // reset_score()
+        snprintf(text + len, sizeof(text) - len, " (total %+lld)",
+                 Side_total);
+        table_side_bets(text);
+} // settle_side_bets()
 
 
 
@@ -118,21 +134,55 @@ static void deal_cards(void)
         unsigned int i;
         unsigned char suit;
         unsigned char pattern;
+        unsigned char player[2];
+        unsigned char upcard = 0;
 
         // deal two cards each 
         for (i=0; i < 2; ++i) {
-                card_get(&suit, &pattern);
+                deal(&suit, &pattern);
                 table_player_card(suit, pattern);
-                update_score(&Player_score, pattern);
+                score_update(&Session->player, pattern);
+                player[i] = CARD_CODE(suit, pattern);
 
-                card_get(&suit, &pattern);
+                deal(&suit, &pattern);
                 table_dealer_card(suit, pattern);
-                update_score(&Dealer_score, pattern);
+                score_update(&Session->dealer, pattern);
+                if (i == 0) {
+                        Upcard = pattern;
+                        upcard = CARD_CODE(suit, pattern);
+                } else {
+                        Hole_card = pattern;
+                }
+        }
+        if (Sidebets != 0) {
+                settle_side_bets(player, upcard);
         }
 } // deal_cards()
 
 
 
+// Show the values of standing and hitting from the equity table, at
+// the true count of the cards the player has not seen.
+static void show_hint(void)
+{
+        char text[HINT_SIZE];
+        const float *ev;
+        int true_count;
+
+        if (!Hinting || score_isover(Session->player)) {
+                return;
+        }
+        true_count = equity_true_count(&Session->shoe, Hole_card);
+        ev = equity_lookup(&Equity, true_count, Upcard, Session->player);
+        snprintf(text, sizeof(text), "Hint (count %+d): stand %+.3f, "
+                 "hit %+.3f: %s", true_count, ev[EQUITY_STAND],
+                 ev[EQUITY_HIT],
+                 ev[EQUITY_HIT] > ev[EQUITY_STAND] ? "HIT" : "STAND");
+        table_hint(0, text);
+} // show_hint()
+
+
+
 static void do_menu(void) {
         char input = 'Z';
         unsigned char suit;
@@ -147,26 +197,34 @@ static void do_menu(void) {
                 hitting = TRUE;
                 natural_win = FALSE;
                 table_reset();
-                reset_scores();
+                session_reset_scores(Session);
                 deal_cards();
 
                 // See if the player wins automatically with 21
-                if (best_score(Player_score) == BEST_SCORE) {
+                if (score_best(Session->player) == BEST_SCORE) {
                         hitting = FALSE;
                         natural_win = TRUE;
                 }
 
                 // what does player want to do?
                 while (hitting) {
+                        show_hint();
+                        if (Simulating) {
+                                hint_start(&Hint, &Session->shoe,
+                                           Hole_card, Upcard,
+                                           Session->player);
+                        }
                         input = table_get_input();
+                        hint_stop(&Hint);
                         switch (input) {
                                 case 'h':
                                 case 'H':
                                         // player wants to hit
-                                        card_get(&suit, &pattern);
+                                        deal(&suit, &pattern);
                                         table_player_card(suit, pattern);
-                                        update_score(&Player_score,pattern);
-                                        if (isover(Player_score)) {
+                                        score_update(&Session->player,
+                                                     pattern);
+                                        if (score_isover(Session->player)) {
                                                 table_player_lost();
                                                 hitting = FALSE;
                                         }
@@ -192,44 +250,41 @@ static void do_menu(void) {
                         // do nothing
                 } else if (natural_win) {
                         // check for a draw
-                       if (best_score(Dealer_score) == BEST_SCORE) {
+                       if (score_best(Session->dealer) == BEST_SCORE) {
                                 table_player_draw();
                        }
-                } else if (!isover(Player_score)) {
+                } else if (!score_isover(Session->player)) {
                         // dealer's turn to choose if player is not over
-                        while (best_score(Dealer_score) <= DRAW_SCORE) {
+                        while (score_best(Session->dealer) <= DRAW_SCORE) {
                                 // Dealer must take a hit
-                                card_get(&suit, &pattern);
+                                deal(&suit, &pattern);
                                 table_dealer_card(suit, pattern);
-                                update_score(&Dealer_score,pattern);
+                                score_update(&Session->dealer, pattern);
                         }
-                        if (isover(Dealer_score)) {
+                        if (score_isover(Session->dealer)) {
                                 table_player_won();
-                        } else if (best_score(Player_score) > 
-                                   best_score(Dealer_score)) {
+                        } else if (score_best(Session->player) > 
+                                   score_best(Session->dealer)) {
                                 table_player_won();
-                        } else if (best_score(Player_score) ==
-                                   best_score(Dealer_score)) {
+                        } else if (score_best(Session->player) ==
+                                   score_best(Session->dealer)) {
                                 table_player_draw();
                         } else {
                                 table_player_lost();
                         }
                 }
-                reset_scores();
+                session_reset_scores(Session);
         }
 } // do_menu()
 
 
 
-// *********************************************************************
-// **************************** M A I N ********************************
-// *********************************************************************
-int main(int argc, char *argv[])
+// Put the terminal into raw mode. Returns SUCCESS or an errno value.
+static int set_raw_mode(void)
 {
         int result = SUCCESS;
         struct termios new_trm;
 
-        // Put terminal into raw mode.
         // Borrowed from www.lafn.org/~dave/linux/terminalIO.html
         errno = 0;
         tcgetattr(STDIN_FILENO, &Old_trm); // get current settings
@@ -249,24 +304,141 @@ int main(int argc, char *argv[])
                         Changed = TRUE;
                 }
         }
+
+        return result;
+} // set_raw_mode()
+
+
+
+// *********************************************************************
+// **************************** M A I N ********************************
+// *********************************************************************
+int main(int argc, char *argv[])
+{
+        int result = SUCCESS;
+        const char *broadcast_path = NULL;
+        const char *script_path = NULL;
+        const char *equity_path = NULL;
+        int script_fd = -1;
+        uint64_t seed = times(NULL);
+        int opt;
+
+        while ((opt = getopt(argc, argv, "b:e:f:Hp:s:")) != -1) {
+                switch (opt) {
+                case 'b':
+                        // spectators connect to this Unix socket
+                        broadcast_path = optarg;
+                        break;
+                case 'e':
+                        // hints from an equity table (see mkequity)
+                        equity_path = optarg;
+                        break;
+                case 'f':
+                        // keys come from this file ("-": standard input)
+                        script_path = optarg;
+                        break;
+                case 'H':
+                        // simulate the hand while the player decides
+                        Simulating = TRUE;
+                        break;
+                case 'p':
+                        // side bets: pp, 21+3, ll or all
+                        Sidebets = sidebet_parse(optarg);
+                        if (Sidebets <= 0) {
+                                fprintf(stderr, "%s: unknown side bet in "
+                                        "'%s'\n", argv[0], optarg);
+                                return -1;
+                        }
+                        break;
+                case 's':
+                        seed = strtoull(optarg, NULL, 0);
+                        break;
+                default:
+                        fprintf(stderr, "usage: %s [-b socket] "
+                                "[-e equity_file] [-f script] [-H] "
+                                "[-p pp,21+3,ll] [-s seed]\n", argv[0]);
+                        return -1;
+                }
+        }
+        if (script_path != NULL && broadcast_path != NULL) {
+                fprintf(stderr, "%s: a scripted game is not drawn, so it "
+                        "cannot be broadcast\n", argv[0]);
+                return -1;
+        }
+
+        if (script_path != NULL) {
+                // no terminal to set up
+                if (strcmp(script_path, "-") == 0) {
+                        script_fd = STDIN_FILENO;
+                } else {
+                        script_fd = open(script_path, O_RDONLY);
+                }
+                if (script_fd < 0) {
+                        result = errno;
+                        perror("Error: unable to open the script");
+                }
+        } else {
+                result = set_raw_mode();
+        }
         
         if (result == SUCCESS) {
                 // register exit handler
                 atexit(when_exiting);
 
-                // initialize the Card module
-                card_init();
+                // create the session (shoe and scores) for this game
+                result = arena_init(&Arena, session_arena_size(1));
+                if (result == SUCCESS) {
+                        Session = session_create(&Arena, 1, seed);
+                }
+                if (Session == NULL) {
+                        printf("The session could not be created.\n");
+                        result = -1;
+                }
+        }
+
+        if (result == SUCCESS && equity_path != NULL) {
+                // mapped, so there is nothing to load or compute; the
+                // dealer here stands on all 17s
+                result = equity_open(&Equity, equity_path, FALSE);
+                if (result != SUCCESS) {
+                        perror("Error: unable to open the equity table");
+                } else {
+                        Hinting = TRUE;
+                }
+        }
 
+        if (result == SUCCESS) {
                 // initialize the table
-                result = table_init();
+                if (script_fd >= 0) {
+                        result = table_init_script(script_fd);
+                        Scripted = TRUE;
+                } else {
+                        result = table_init();
+                }
                 if (result != SUCCESS) {
                         printf("The board could not be initialized.\n");
                 } 
         }
 
+        if (result == SUCCESS && Simulating) {
+                // the table runs the simulation while it waits for keys
+                hint_init(&Hint, rng_stream_seed(seed, HINT_STREAM));
+                table_set_idle(hint_idle, &Hint);
+        }
+
+        if (result == SUCCESS && broadcast_path != NULL) {
+                result = broadcast_start(&Broadcast, broadcast_path);
+                if (result != SUCCESS) {
+                        perror("Error: unable to start the broadcast");
+                } else {
+                        Broadcasting = TRUE;
+                        table_set_broadcast(&Broadcast);
+                }
+        }
+
         if (result == SUCCESS) {
                 // initialize score
-                reset_scores();
+                session_reset_scores(Session);
 
                 // start the game
                 do_menu();
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------
+// file: mkequity.c
+//
+// Description: This is the main entry point for the equity table
+//     generator. It computes the expected values of standing and hitting
+//     for every hand, up card and true count (see equity.h) and writes
+//     them to the file that blackjack -e maps for its hints.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "common.h"
+#include "equity.h"
+
+
+static void usage(const char *name)
+{
+        fprintf(stderr, "usage: %s -o out_file [-H]\n"
+                "    -H  the dealer hits soft 17 (the game stands)\n",
+                name);
+} // usage()
+
+
+
+// *********************************************************************
+// **************************** M A I N ********************************
+// *********************************************************************
+int main(int argc, char *argv[])
+{
+        static struct equity_table_t table;
+        const char *out_file = NULL;
+        int hit_soft_17 = FALSE;
+        int num_hits = 0;
+        int opt;
+
+        while ((opt = getopt(argc, argv, "o:H")) != -1) {
+                switch (opt) {
+                        case 'o':
+                                out_file = optarg;
+                                break;
+                        case 'H':
+                                hit_soft_17 = TRUE;
+                                break;
+                        default:
+                                usage(argv[0]);
+                                return 1;
+                }
+        }
+        if (out_file == NULL) {
+                usage(argv[0]);
+                return 1;
+        }
+
+        equity_compute(&table, hit_soft_17);
+        if (equity_save(out_file, &table) != SUCCESS) {
+                perror(out_file);
+                return 1;
+        }
+
+        // a one-line check: how often hitting is right at a count of 0
+        for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                for (int hand = 0; hand < EQUITY_HANDS; ++hand) {
+                        const float *ev = table.ev[-EQUITY_TC_MIN][up][hand];
+                        num_hits += ev[EQUITY_HIT] > ev[EQUITY_STAND];
+                }
+        }
+        printf("wrote %s: %d counts x %d up cards x %d hands (%zu bytes), "
+               "hit in %d of %d cells at count 0\n", out_file,
+               EQUITY_TC_BUCKETS, STRATEGY_UPCARDS, EQUITY_HANDS,
+               sizeof(table), num_hits, STRATEGY_UPCARDS * EQUITY_HANDS);
+
+        return 0;
+} // main()
+
+
+// end of mkequity.c
@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------
+// file: numa.c
+//
+// Description: This file implements the NUMA module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "common.h"
+#include "numa.h"
+
+#define NODE_CPULIST "/sys/devices/system/node/node%d/cpulist"
+#define PATH_SIZE 64
+#define LINE_SIZE 4096
+
+
+
+// Add the usable CPUs of a cpulist ("0-3,8,10-11") to the last node.
+static void add_cpus(struct numa_t *numa, const char *list,
+                     const cpu_set_t *usable)
+{
+        int *end = &numa->first[numa->num_nodes + 1];
+        char *next;
+        long low;
+        long high;
+
+        while (*list != '\0' && *list != '\n') {
+                low = strtol(list, &next, 10);
+                if (next == list) {
+                        break;
+                }
+                high = low;
+                if (*next == '-') {
+                        list = next + 1;
+                        high = strtol(list, &next, 10);
+                }
+                for (long cpu = low; cpu <= high && cpu < CPU_SETSIZE;
+                     ++cpu) {
+                        if (CPU_ISSET(cpu, usable) &&
+                            *end < NUMA_MAX_CPUS) {
+                                numa->cpus[(*end)++] = cpu;
+                        }
+                }
+                list = (*next == ',') ? next + 1 : next;
+        }
+} // add_cpus()
+
+
+
+extern int numa_discover(struct numa_t *numa)
+{
+        char path[PATH_SIZE];
+        char line[LINE_SIZE];
+        cpu_set_t usable;
+        FILE *in;
+
+        if (sched_getaffinity(0, sizeof(usable), &usable) != 0) {
+                return -1;
+        }
+
+        numa->num_nodes = 0;
+        numa->first[0] = 0;
+        for (int id = 0; id < NUMA_MAX_NODES; ++id) {
+                // node numbers may have gaps
+                snprintf(path, sizeof(path), NODE_CPULIST, id);
+                in = fopen(path, "r");
+                if (in == NULL) {
+                        continue;
+                }
+                numa->first[numa->num_nodes + 1] =
+                        numa->first[numa->num_nodes];
+                if (fgets(line, sizeof(line), in) != NULL) {
+                        add_cpus(numa, line, &usable);
+                }
+                fclose(in);
+                if (numa->first[numa->num_nodes + 1] >
+                    numa->first[numa->num_nodes]) {
+                        // memory-only nodes are left out
+                        numa->node_id[numa->num_nodes++] = id;
+                }
+        }
+
+        if (numa->num_nodes == 0) {
+                // no NUMA information: one node with every usable CPU
+                numa->node_id[0] = 0;
+                numa->first[1] = 0;
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                        if (CPU_ISSET(cpu, &usable) &&
+                            numa->first[1] < NUMA_MAX_CPUS) {
+                                numa->cpus[numa->first[1]++] = cpu;
+                        }
+                }
+                numa->num_nodes = numa->first[1] > 0;
+        }
+
+        return numa->num_nodes > 0 ? SUCCESS : -1;
+} // numa_discover()
+
+
+
+extern int numa_place(const struct numa_t *numa, int worker, int *cpu)
+{
+        int node = worker % numa->num_nodes;
+        int count = numa->first[node + 1] - numa->first[node];
+
+        // with more workers than CPUs the CPUs are shared in turn
+        *cpu = numa->cpus[numa->first[node] +
+                          (worker / numa->num_nodes) % count];
+
+        return node;
+} // numa_place()
+
+
+
+extern int numa_pin(int cpu)
+{
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set),
+                                      &set) == 0 ? SUCCESS : -1;
+} // numa_pin()
+
+
+// end of numa.c
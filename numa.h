@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------
+// file: numa.h
+//
+// Description: This is the header file for the NUMA module. It finds
+//     the machine's NUMA nodes and their CPUs (from sysfs, so no library
+//     is needed), places worker threads on them and pins a thread to a
+//     CPU.
+//
+//     Workers are spread over the nodes in turn (worker 0 on node 0,
+//     worker 1 on node 1, ...), each on its own CPU while there are
+//     enough, so every socket gets its share of the work and of the
+//     memory traffic. A pinned thread that then allocates and first
+//     touches its memory gets pages on its own node under the kernel's
+//     default policy.
+//
+//     Only the CPUs this process may run on count. A machine without
+//     NUMA information is one node.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef NUMA_H
+#define NUMA_H
+
+#define NUMA_MAX_NODES 64
+#define NUMA_MAX_CPUS 1024
+
+struct numa_t {
+        int num_nodes;                  // nodes with usable CPUs
+        int node_id[NUMA_MAX_NODES];    // the kernel's number of each
+        int first[NUMA_MAX_NODES + 1];  // each node's CPUs in 'cpus'
+        short cpus[NUMA_MAX_CPUS];
+};
+
+
+// Find the nodes and CPUs. Returns SUCCESS, or -1 if no CPU is usable.
+extern int numa_discover(struct numa_t *numa);
+
+
+// Return the node (an index, not the kernel's number) of worker
+// 'worker', and store the CPU to pin it to in 'cpu'.
+extern int numa_place(const struct numa_t *numa, int worker, int *cpu);
+
+
+// Pin the calling thread to 'cpu'. Returns SUCCESS or -1.
+extern int numa_pin(int cpu);
+
+#endif
+// end of numa.h
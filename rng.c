@@ -0,0 +1,46 @@
+// ----------------------------------------------------------------------
+// file: rng.c
+//
+// Description: This file implements the seeding half of the RNG module.
+//     The generator itself is inline in rng.h.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include "rng.h"
+
+
+// One step of splitmix64, used to spread a seed over the full state.
+static uint64_t splitmix(uint64_t *x)
+{
+        uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+} // splitmix()
+
+
+
+extern void rng_seed(struct rng_t *rng, uint64_t seed)
+{
+        uint64_t x = seed;
+
+        rng->s[0] = splitmix(&x);
+        rng->s[1] = splitmix(&x);
+        rng->s[2] = splitmix(&x);
+        rng->s[3] = splitmix(&x);
+} // rng_seed()
+
+
+
+extern uint64_t rng_stream_seed(uint64_t seed, uint64_t stream)
+{
+        uint64_t x = seed ^ (stream * 0xd1342543de82ef95ULL);
+
+        splitmix(&x);
+        return splitmix(&x);
+} // rng_stream_seed()
+
+
+// end of rng.c
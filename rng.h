@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------
+// file: rng.h
+//
+// Description: This is the header file for the RNG module. It provides
+//     a small, seedable pseudo random number generator (xoshiro256**)
+//     whose whole state lives in a struct, so every shoe or simulation
+//     worker can own an independent and reproducible stream instead of
+//     sharing the process-wide random() state.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+struct rng_t {
+        uint64_t s[4];
+};
+
+
+// Seed the generator. Any seed (including 0) gives a usable state.
+extern void rng_seed(struct rng_t *rng, uint64_t seed);
+
+
+// Mix a base seed with a stream number so that related streams (one per
+// chunk, worker, candidate policy...) are statistically independent.
+extern uint64_t rng_stream_seed(uint64_t seed, uint64_t stream);
+
+
+// The two functions below sit in the dealing loop, so they are defined
+// here to let the compiler inline them.
+
+static inline uint64_t rng_rotl(const uint64_t x, int k)
+{
+        return (x << k) | (x >> (64 - k));
+}
+
+
+// Return the next 64 random bits.
+static inline uint64_t rng_next(struct rng_t *rng)
+{
+        uint64_t *s = rng->s;
+        const uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rng_rotl(s[3], 45);
+
+        return result;
+} // rng_next()
+
+
+// Return a uniformly distributed integer in [0, bound). Unlike
+// "random() % bound" this has no modulo bias: the multiply-shift maps
+// 32 random bits onto the range and the rare low products that would
+// over-represent some values are rejected.
+static inline uint32_t rng_below(struct rng_t *rng, uint32_t bound)
+{
+        uint64_t m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+        uint32_t low = (uint32_t)m;
+
+        if (low < bound) {
+                uint32_t threshold = -bound % bound;
+                while (low < threshold) {
+                        m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+                        low = (uint32_t)m;
+                }
+        }
+
+        return (uint32_t)(m >> 32);
+} // rng_below()
+
+
+// Return a uniformly distributed double in [0, 1).
+static inline double rng_uniform(struct rng_t *rng)
+{
+        return (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif
+// end of rng.h
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------
+// file: score.c
+//
+// Description: This file implements the SCORE module. The functions
+//     were moved here from main.c so that the interactive game and the
+//     headless sessions share one set of scoring rules.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include "common.h"
+#include "card.h"
+#include "score.h"
+
+
+extern int score_best(struct score_t score)
+{
+        int tot;
+
+        // First calc the lowest possible score
+        tot = score.tot_other + score.num_aces;
+
+        // Now see if we can improve the score by replacing one of the
+        // aces with an '11'. We can obviously only do that once or we
+        // automatically go over.
+        if (score.num_aces > 0) {
+                if ((tot - LOW_ACE + HIGH_ACE) <= BEST_SCORE) {
+                        tot = tot - LOW_ACE + HIGH_ACE;
+                }
+        }
+
+        return tot;
+} // score_best()
+
+
+
+extern unsigned char score_isover(struct score_t score)
+{
+        unsigned char result;
+
+        if (score_best(score) > BEST_SCORE) {
+                result = TRUE;
+        }  else {
+                result = FALSE;
+        }
+
+        return result;
+} // score_isover()
+
+
+
+extern void score_update(struct score_t *score, unsigned char pattern)
+{
+        if (pattern > ACE && pattern < JACK) {
+                score->tot_other = score->tot_other + pattern;
+        } else if (pattern == ACE) {
+                score->num_aces = score->num_aces + 1;
+        } else {
+                // face card
+                score->tot_other = score->tot_other + 10;
+        }
+} // score_update()
+
+
+
+extern void score_reset(struct score_t *score)
+{
+        score->num_aces = 0;
+        score->tot_other = 0;
+} // score_reset()
+
+
+// end of score.c
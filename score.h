@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------
+// file: score.h
+//
+// Description: This is the header file for the SCORE module. It keeps
+//     the running score of a blackjack hand and knows the scoring rules
+//     that used to live in main.c.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef SCORE_H
+#define SCORE_H
+
+#define DRAW_SCORE 16
+#define BEST_SCORE 21
+#define LOW_ACE 1
+#define HIGH_ACE 11
+
+
+// new type for keeping score of current hand for player and dealer
+struct score_t {
+        unsigned char num_aces;
+        unsigned char tot_other;
+};
+
+
+// Return the best total for the hand (one ace counted as 11 if that
+// does not go over BEST_SCORE).
+extern int score_best(struct score_t score);
+
+
+// Return TRUE if the hand is over BEST_SCORE.
+extern unsigned char score_isover(struct score_t score);
+
+
+// Add a card (by pattern) to the hand.
+extern void score_update(struct score_t *score, unsigned char pattern);
+
+
+// Empty the hand.
+extern void score_reset(struct score_t *score);
+
+#endif
+// end of score.h
@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------
+// file: session.c
+//
+// Description: This file implements the SESSION module. The hands
+//     themselves are played by the ENGINE module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include "common.h"
+#include "session.h"
+
+extern size_t session_arena_size(int num_sessions)
+{
+        size_t one;
+
+        one = (sizeof(struct session_t) + ARENA_ALIGN - 1) &
+              ~((size_t)ARENA_ALIGN - 1);
+        return one * num_sessions;
+} // session_arena_size()
+
+
+
+extern struct session_t *session_create(struct arena_t *arena,
+                                        int num_decks, uint64_t seed)
+{
+        struct session_t *session;
+        struct rules_t rules;
+
+        session = arena_alloc(arena, sizeof(struct session_t));
+        if (session != NULL) {
+                if (shoe_init(&session->shoe, num_decks, seed) != SUCCESS) {
+                        session = NULL;
+                } else {
+                        rules_default(&rules);
+                        session_set_rules(session, &rules);
+                }
+        }
+
+        return session;
+} // session_create()
+
+
+
+extern void session_reset_scores(struct session_t *session)
+{
+        score_reset(&session->player);
+        score_reset(&session->dealer);
+} // session_reset_scores()
+
+
+
+extern void session_set_sidebets(struct session_t *session, int sidebets)
+{
+        session->sidebets = sidebets;
+        session->sidebet_table = sidebet_table();
+        session->engine = engine_select(session);
+} // session_set_sidebets()
+
+
+
+extern void session_set_strategy(struct session_t *session,
+                                 const struct strategy_t *strategy)
+{
+        session->strategy = strategy;
+        session->engine = engine_select(session);
+} // session_set_strategy()
+
+
+
+extern void session_set_table(struct session_t *session,
+                              struct stats_table_t *table)
+{
+        session->table = table;
+        session->engine = engine_select(session);
+} // session_set_table()
+
+
+
+extern void session_set_control(struct session_t *session,
+                                const struct control_table_t *table)
+{
+        session->control_table = table;
+        session->control = 0;
+        session->engine = engine_select(session);
+} // session_set_control()
+
+
+
+extern void session_set_rules(struct session_t *session,
+                              const struct rules_t *rules)
+{
+        session->rules = *rules;
+        session->engine = engine_select(session);
+        session->dealer_table = dealer_table(rules->hit_soft_17);
+} // session_set_rules()
+
+
+
+extern int session_play_hand(struct session_t *session)
+{
+        return session->engine->play_hand(session);
+} // session_play_hand()
+
+
+// end of session.c
@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------
+// file: session.h
+//
+// Description: This is the header file for the SESSION module. A
+//     session is one seat at one table: its own shoe, the player's and
+//     dealer's scores and the running results. All of that lives in a
+//     single object carved out of an arena when the session is created,
+//     so any number of sessions can play side by side and playing a
+//     hand never allocates memory.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "card.h"
+#include "score.h"
+#include "strategy.h"
+#include "engine.h"
+#include "dealer.h"
+#include "sidebet.h"
+
+struct control_table_t;
+
+// Payoffs are counted in half bets so that every payout is an integer.
+#define PAYOFF_LOSS (-2)
+#define PAYOFF_DRAW 0
+#define PAYOFF_WIN  2
+
+struct session_t {
+        struct shoe_t shoe;
+        struct score_t player;
+        struct score_t dealer;              // the two cards dealt first
+        const struct strategy_t *strategy;  // NULL: play like the dealer
+        struct rules_t rules;
+        const struct engine_t *engine;      // plays hands under 'rules'
+                                            // ...and the options below
+        const struct dealer_table_t *dealer_table;  // ...with this table
+        const struct control_table_t *control_table;    // NULL: none
+        int control;    // control variate of the last hand (see below)
+        struct stats_table_t *table;    // if set, results by start hand
+        int sidebets;                   // mask of side bets placed
+        const struct sidebet_table_t *sidebet_table;
+        struct sidebet_totals_t side;   // ...and their results
+        unsigned long long hands;
+        unsigned long long wins;
+        unsigned long long losses;
+        unsigned long long draws;
+};
+
+
+// Number of arena bytes needed for 'num_sessions' sessions.
+extern size_t session_arena_size(int num_sessions);
+
+
+// Create a session in 'arena' playing from a shoe of 'num_decks' decks
+// seeded with 'seed', under the rules of the interactive game. Returns
+// NULL if the arena is full or the number of decks is not supported.
+extern struct session_t *session_create(struct arena_t *arena,
+                                        int num_decks, uint64_t seed);
+
+
+// Empty the player's and dealer's hands.
+extern void session_reset_scores(struct session_t *session);
+
+
+// Change the rules of a session; this also picks its engine and
+// dealer table. (Each of the setters picks the engine again: the engine
+// is specialized for the session's options as well.)
+extern void session_set_rules(struct session_t *session,
+                              const struct rules_t *rules);
+
+
+// Place the side bets in the mask 'sidebets' (see sidebet.h) on every
+// hand played from now on; 0 places none. Their results are added to
+// session->side.
+extern void session_set_sidebets(struct session_t *session, int sidebets);
+
+
+// Play the hands from now on with 'strategy' (NULL: like the dealer).
+extern void session_set_strategy(struct session_t *session,
+                                 const struct strategy_t *strategy);
+
+
+// Add the results of the hands from now on to 'table' by starting hand
+// and up card (NULL: do not).
+extern void session_set_table(struct session_t *session,
+                              struct stats_table_t *table);
+
+
+// Add up the control variate of the hands from now on with 'table'
+// (see control.h), which must have been built for the session's rules
+// and strategy; NULL leaves session->control at 0.
+extern void session_set_control(struct session_t *session,
+                                const struct control_table_t *table);
+
+
+// Play one complete hand without any display, under the session's
+// rules (by default those of the interactive game). The player follows
+// the session's strategy, or draws until reaching more than DRAW_SCORE,
+// as the dealer does, if it has none. Returns the payoff in half bets.
+//
+// The hand's control variate is left in session->control. Each card
+// dealt adds how much more the hand is worth after it (looked up in the
+// control table) than after the average card left in the shoe, times
+// the cards left, times a weight of about CONTROL_WEIGHT over the cards
+// left that keeps the terms on one scale. Each term has a mean of zero
+// given everything dealt before, so the control's mean is exactly zero
+// however the shoe has been played, and as the values add up to the
+// payoff the control follows it closely.
+extern int session_play_hand(struct session_t *session);
+
+#endif
+// end of session.h
@@ -0,0 +1,293 @@
+// ----------------------------------------------------------------------
+// file: sidebet.c
+//
+// Description: This file implements the SIDEBET module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <pthread.h>
+#include <string.h>
+#include "common.h"
+#include "score.h"
+#include "sidebet.h"
+
+#define LOSS (-1)
+#define NAME_SIZE 64
+
+static struct sidebet_table_t Table;
+static pthread_once_t Table_once = PTHREAD_ONCE_INIT;
+
+static const char *Names[SIDEBET_KINDS] = { "pp", "21+3", "ll" };
+
+
+
+// Clubs and spades are black, hearts and diamonds red.
+static int color(unsigned char code)
+{
+        return CARD_SUIT(code) % 2;
+} // color()
+
+
+
+// A card's value towards the 20 of Lucky Ladies (an ace counts 11).
+static int ladies_value(unsigned char code)
+{
+        int pattern = CARD_PATTERN(code);
+
+        if (pattern == ACE) {
+                return HIGH_ACE;
+        }
+        return pattern < 10 ? pattern : 10;
+} // ladies_value()
+
+
+
+static int pair_payoff(unsigned char a, unsigned char b)
+{
+        if (CARD_PATTERN(a) != CARD_PATTERN(b)) {
+                return LOSS;
+        }
+        if (a == b) {
+                return 25;
+        }
+        return color(a) == color(b) ? 12 : 6;
+} // pair_payoff()
+
+
+
+static int ladies_payoff(unsigned char a, unsigned char b)
+{
+        if (ladies_value(a) + ladies_value(b) != 20) {
+                return LOSS;
+        }
+        if (a == SIDEBET_QUEEN_OF_HEARTS && b == SIDEBET_QUEEN_OF_HEARTS) {
+                return 125;
+        }
+        if (a == b) {
+                return 19;
+        }
+        return CARD_SUIT(a) == CARD_SUIT(b) ? 9 : 4;
+} // ladies_payoff()
+
+
+
+static int three_class(int x, int y, int z)
+{
+        int low = x;
+        int high = x;
+
+        if (x == y && y == z) {
+                return SIDEBET_TRIPS;
+        }
+        if (x == y || y == z || x == z) {
+                return SIDEBET_NOTHING;
+        }
+        low = y < low ? y : low;
+        low = z < low ? z : low;
+        high = y > high ? y : high;
+        high = z > high ? z : high;
+        if (high - low == 2) {
+                return SIDEBET_STRAIGHT;
+        }
+        // queen, king, ace: the ace plays high
+        if (low == ACE && x + y + z == ACE + QUEEN + KING) {
+                return SIDEBET_STRAIGHT;
+        }
+        return SIDEBET_NOTHING;
+} // three_class()
+
+
+
+static void build_table(void)
+{
+        for (int a = 0; a < SIDEBET_CODES; ++a) {
+                for (int b = 0; b < SIDEBET_CODES; ++b) {
+                        // codes that are not cards are never looked up
+                        Table.pairs[a][b] = pair_payoff(a, b);
+                        Table.ladies[a][b] = ladies_payoff(a, b);
+                }
+        }
+        for (int x = 0; x <= KING; ++x) {
+                for (int y = 0; y <= KING; ++y) {
+                        for (int z = 0; z <= KING; ++z) {
+                                Table.three[x][y][z] = three_class(x, y, z);
+                        }
+                }
+        }
+        Table.three_pay[SIDEBET_NOTHING][FALSE] = LOSS;
+        Table.three_pay[SIDEBET_NOTHING][TRUE] = 5;
+        Table.three_pay[SIDEBET_STRAIGHT][FALSE] = 10;
+        Table.three_pay[SIDEBET_STRAIGHT][TRUE] = 40;
+        Table.three_pay[SIDEBET_TRIPS][FALSE] = 30;
+        Table.three_pay[SIDEBET_TRIPS][TRUE] = 100;
+} // build_table()
+
+
+
+extern const struct sidebet_table_t *sidebet_table(void)
+{
+        pthread_once(&Table_once, build_table);
+
+        return &Table;
+} // sidebet_table()
+
+
+
+extern const char *sidebet_name(int kind)
+{
+        return Names[kind];
+} // sidebet_name()
+
+
+
+extern int sidebet_parse(const char *list)
+{
+        char copy[NAME_SIZE];
+        char *word;
+        int mask = 0;
+        int k;
+
+        if (strlen(list) >= sizeof(copy)) {
+                return -1;
+        }
+        strcpy(copy, list);
+        for (word = strtok(copy, ","); word != NULL;
+             word = strtok(NULL, ",")) {
+                if (strcmp(word, "all") == 0) {
+                        mask |= SIDEBET_ALL;
+                        continue;
+                }
+                for (k = 0; k < SIDEBET_KINDS; ++k) {
+                        if (strcmp(word, Names[k]) == 0) {
+                                break;
+                        }
+                }
+                if (k == SIDEBET_KINDS) {
+                        return -1;
+                }
+                mask |= 1 << k;
+        }
+
+        return mask;
+} // sidebet_parse()
+
+
+
+extern void sidebet_merge(struct sidebet_totals_t *dst,
+                          const struct sidebet_totals_t *src)
+{
+        for (int k = 0; k < SIDEBET_KINDS; ++k) {
+                dst->bets[k] += src->bets[k];
+                dst->wins[k] += src->wins[k];
+                dst->payoff[k] += src->payoff[k];
+                dst->payoff_sq[k] += src->payoff_sq[k];
+        }
+} // sidebet_merge()
+
+
+
+// Count the cards of each code a shoe has left. Returns TRUE if it
+// deals them without replacement.
+static int cards_left(const struct shoe_t *shoe,
+                      unsigned int counts[SIDEBET_CODES])
+{
+        memset(counts, 0, sizeof(counts[0]) * SIDEBET_CODES);
+        for (int i = 0; i < shoe->num_cards; ++i) {
+                ++counts[shoe->cards[i]];
+        }
+        if (shoe->mode == SHOE_INFINITE) {
+                return FALSE;
+        }
+
+        // a machine's dealt cards are in its tray; the others deal from
+        // the front of cards[]
+        for (int i = 0; i < shoe->next; ++i) {
+                if (shoe->mode == SHOE_CSM) {
+                        --counts[shoe->cards[shoe->csm.tray[i]]];
+                } else {
+                        --counts[shoe->cards[i]];
+                }
+        }
+
+        return TRUE;
+} // cards_left()
+
+
+
+extern void sidebet_exact(const struct shoe_t *shoe,
+                          double ev[SIDEBET_KINDS])
+{
+        const struct sidebet_table_t *table = sidebet_table();
+        unsigned int counts[SIDEBET_CODES];
+        double aces = 0;
+        double tens = 0;
+        double n = 0;
+        int w;          // 1 without replacement, 0 with
+
+        w = cards_left(shoe, counts);
+        for (int c = 0; c < SIDEBET_CODES; ++c) {
+                n += counts[c];
+                if (CARD_PATTERN(c) == ACE) {
+                        aces += counts[c];
+                } else if (CARD_PATTERN(c) >= 10) {
+                        tens += counts[c];
+                }
+        }
+        for (int k = 0; k < SIDEBET_KINDS; ++k) {
+                ev[k] = 0;
+        }
+        if (n < 4) {
+                return;
+        }
+
+        // the player's cards a and b, then the up card u; the order the
+        // three are dealt in does not change their joint odds
+        for (int a = 0; a < SIDEBET_CODES; ++a) {
+                double pa = counts[a] / n;
+
+                if (counts[a] == 0) {
+                        continue;
+                }
+                for (int b = 0; b < SIDEBET_CODES; ++b) {
+                        double cb = counts[b] - (double)w * (b == a);
+                        double pab = pa * cb / (n - w);
+                        double ladies = table->ladies[a][b];
+
+                        if (cb <= 0) {
+                                continue;
+                        }
+                        ev[SIDEBET_PERFECT_PAIRS] += pab * table->pairs[a][b];
+                        if (a == SIDEBET_QUEEN_OF_HEARTS &&
+                            b == SIDEBET_QUEEN_OF_HEARTS) {
+                                // an ace and a ten from the rest, in
+                                // either order, for the dealer
+                                double natural = 2 * aces * (tens - 2 * w) /
+                                                 ((n - 2 * w) * (n - 3 * w));
+                                ladies = natural * SIDEBET_LADIES_JACKPOT +
+                                         (1 - natural) * ladies;
+                        }
+                        ev[SIDEBET_LUCKY_LADIES] += pab * ladies;
+
+                        for (int u = 0; u < SIDEBET_CODES; ++u) {
+                                double cu = counts[u] -
+                                            (double)w * ((u == a) + (u == b));
+                                int suited = CARD_SUIT(a) == CARD_SUIT(b) &&
+                                             CARD_SUIT(b) == CARD_SUIT(u);
+
+                                if (cu <= 0) {
+                                        continue;
+                                }
+                                ev[SIDEBET_21_PLUS_3] += pab * cu /
+                                        (n - 2 * w) * table->three_pay
+                                        [table->three[CARD_PATTERN(a)]
+                                                     [CARD_PATTERN(b)]
+                                                     [CARD_PATTERN(u)]]
+                                        [suited];
+                        }
+                }
+        }
+} // sidebet_exact()
+
+
+// end of sidebet.c
@@ -0,0 +1,141 @@
+// ----------------------------------------------------------------------
+// file: sidebet.h
+//
+// Description: This is the header file for the SIDEBET module. It
+//     scores the common side bets, which are settled on the first cards
+//     of a hand, and works out their exact value for a shoe.
+//
+//     Perfect Pairs (the player's two cards):
+//         perfect pair (same pattern and suit)     25 to 1
+//         colored pair (same pattern and color)    12 to 1
+//         mixed pair (same pattern)                 6 to 1
+//     21+3 (the player's two cards and the dealer's up card):
+//         suited three of a kind                  100 to 1
+//         straight flush                           40 to 1
+//         three of a kind                          30 to 1
+//         straight (ace high or low)               10 to 1
+//         flush                                     5 to 1
+//     Lucky Ladies (the player's two cards totalling 20):
+//         two queens of hearts, dealer natural   1000 to 1
+//         two queens of hearts                    125 to 1
+//         matched 20 (same pattern and suit)       19 to 1
+//         suited 20                                 9 to 1
+//         any 20                                    4 to 1
+//
+//     Scoring a hand costs a few lookups in tables built once and
+//     indexed by the packed card codes (see card.h), so the simulator
+//     can settle the side bets of every hand for almost nothing.
+//     Payoffs are in units of the side bet: the payout when it wins, -1
+//     when it loses.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef SIDEBET_H
+#define SIDEBET_H
+
+#include <stdint.h>
+#include "card.h"
+
+#define SIDEBET_PERFECT_PAIRS 0
+#define SIDEBET_21_PLUS_3 1
+#define SIDEBET_LUCKY_LADIES 2
+#define SIDEBET_KINDS 3
+#define SIDEBET_ALL ((1 << SIDEBET_KINDS) - 1)     // a mask of every kind
+
+#define SIDEBET_CODES (CARD_CODE(DIAMONDS, KING) + 1)
+#define SIDEBET_QUEEN_OF_HEARTS CARD_CODE(HEARTS, QUEEN)
+#define SIDEBET_LADIES_JACKPOT 1000
+
+// 21+3 classes of three patterns
+#define SIDEBET_NOTHING 0
+#define SIDEBET_STRAIGHT 1
+#define SIDEBET_TRIPS 2
+
+struct sidebet_table_t {
+        short pairs[SIDEBET_CODES][SIDEBET_CODES];   // Perfect Pairs
+        short ladies[SIDEBET_CODES][SIDEBET_CODES];  // ...no dealer natural
+        unsigned char three[KING + 1][KING + 1][KING + 1];  // 21+3 class
+        short three_pay[3][2];          // by class, then TRUE if suited
+};
+
+// Results of side bets, by kind.
+struct sidebet_totals_t {
+        uint64_t bets[SIDEBET_KINDS];
+        uint64_t wins[SIDEBET_KINDS];
+        int64_t payoff[SIDEBET_KINDS];
+        uint64_t payoff_sq[SIDEBET_KINDS];
+};
+
+
+// Return the scoring tables (built on the first call).
+extern const struct sidebet_table_t *sidebet_table(void);
+
+
+// Return the short name of a kind ("pp", "21+3" or "ll").
+extern const char *sidebet_name(int kind);
+
+
+// Parse a comma-separated list of names (or "all") into a mask of
+// kinds. Returns the mask, or -1 if a name is unknown.
+extern int sidebet_parse(const char *list);
+
+
+// Add one set of results to another.
+extern void sidebet_merge(struct sidebet_totals_t *dst,
+                          const struct sidebet_totals_t *src);
+
+
+// Store the exact expected payoff of each kind for the next hand dealt
+// from 'shoe', given the cards it has left (every card for an infinite
+// shoe, which deals with replacement).
+extern void sidebet_exact(const struct shoe_t *shoe,
+                          double ev[SIDEBET_KINDS]);
+
+
+// Score every kind for a hand whose player holds 'first' and 'second'
+// (codes) against 'upcard'; 'dealer_natural' is TRUE if the dealer has
+// a natural.
+static inline void sidebet_score(const struct sidebet_table_t *table,
+                                 unsigned char first, unsigned char second,
+                                 unsigned char upcard, int dealer_natural,
+                                 int payoff[SIDEBET_KINDS])
+{
+        int suited = CARD_SUIT(first) == CARD_SUIT(second) &&
+                     CARD_SUIT(second) == CARD_SUIT(upcard);
+
+        payoff[SIDEBET_PERFECT_PAIRS] = table->pairs[first][second];
+        payoff[SIDEBET_21_PLUS_3] = table->three_pay
+                [table->three[CARD_PATTERN(first)][CARD_PATTERN(second)]
+                             [CARD_PATTERN(upcard)]][suited];
+        payoff[SIDEBET_LUCKY_LADIES] = table->ladies[first][second];
+        if (dealer_natural && first == SIDEBET_QUEEN_OF_HEARTS &&
+            second == SIDEBET_QUEEN_OF_HEARTS) {
+                payoff[SIDEBET_LUCKY_LADIES] = SIDEBET_LADIES_JACKPOT;
+        }
+} // sidebet_score()
+
+
+// Score the kinds in the mask 'bets' and add them to 'totals'.
+static inline void sidebet_record(const struct sidebet_table_t *table,
+                                  int bets, unsigned char first,
+                                  unsigned char second,
+                                  unsigned char upcard, int dealer_natural,
+                                  struct sidebet_totals_t *totals)
+{
+        int payoff[SIDEBET_KINDS];
+
+        sidebet_score(table, first, second, upcard, dealer_natural, payoff);
+        for (int k = 0; k < SIDEBET_KINDS; ++k) {
+                if (bets & (1 << k)) {
+                        ++totals->bets[k];
+                        totals->wins[k] += payoff[k] > 0;
+                        totals->payoff[k] += payoff[k];
+                        totals->payoff_sq[k] +=
+                                (uint64_t)(payoff[k] * payoff[k]);
+                }
+        }
+} // sidebet_record()
+
+#endif
+// end of sidebet.h
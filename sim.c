@@ -0,0 +1,888 @@
+// ----------------------------------------------------------------------
+// file: sim.c
+//
+// Description: This file implements the SIM module. The chunks of every
+//     job of a run are numbered one after the other, and worker threads
+//     take them from a shared counter, so a worker that finishes a cheap
+//     chunk simply takes the next one, whichever job it belongs to. Each
+//     worker plays a job with a session of its own for that job and
+//     records every hand in its own stats accumulators (one per job and
+//     strategy). The calling thread acts as the monitor: it reads live
+//     totals from the accumulators and saves checkpoints while the
+//     workers run.
+//
+//     Each worker allocates its session, accumulators and export record
+//     from an arena of its own, on its own thread (after pinning itself
+//     with config->numa), so the memory it plays in is first touched,
+//     and placed, where it runs. The calling thread starts the workers
+//     one at a time and waits for each to be set up.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include "common.h"
+#include "arena.h"
+#include "session.h"
+#include "control.h"
+#include "stats.h"
+#include "checkpoint.h"
+#include "numa.h"
+#include "sim.h"
+
+
+// One simulation of a run, and where its chunks are in the run's
+// numbering.
+struct job_t {
+        const struct sim_config_t *config;
+        int num_strategies;
+        unsigned long long first_chunk;     // in the run's numbering
+        unsigned long long num_chunks;
+        struct control_table_t *controls;   // per strategy, or NULL
+        struct sim_config_t dealer_only;    // the config with no strategy
+};
+
+// What a worker plays one job with.
+struct seat_t {
+        struct session_t *session;
+        struct stats_acc_t *accs;          // one per strategy
+        struct export_record_t *record;    // NULL unless exporting
+};
+
+struct worker_t {
+        const struct job_t *jobs;
+        int num_jobs;
+        struct arena_t arena;              // holds the seats
+        struct seat_t seats[SIM_MAX_JOBS];
+        atomic_ullong *next_chunk;
+        unsigned long long num_chunks;     // of every job
+        atomic_int *running;
+        pthread_mutex_t *done_lock;        // signal 'all_done' under it
+        pthread_cond_t *all_done;
+
+        // checkpoints of a single job (all NULL if there are none)
+        pthread_mutex_t *commit_lock;
+        struct stats_t *committed;         // totals of finished chunks
+        unsigned char *done;               // bitmap of finished chunks
+        const unsigned char *skip;         // ...finished before resuming
+
+        // placement
+        int node;                          // index in the numa_t
+        int cpu;                           // -1 if not pinned
+        int ok;                            // set up and playing
+        sem_t *ready;                      // posted once set up (or not)
+        unsigned long long hands;          // played, for throughput
+        double seconds;
+};
+
+// Shared state of one run.
+struct run_t {
+        struct arena_t arena;
+        struct job_t jobs[SIM_MAX_JOBS];
+        int num_jobs;
+        struct worker_t workers[SIM_MAX_THREADS];
+        pthread_t threads[SIM_MAX_THREADS];
+        int num_workers;                    // set up, with accumulators
+        sem_t ready;
+        atomic_ullong next_chunk;
+        atomic_int running;
+        pthread_mutex_t done_lock;
+        pthread_cond_t all_done;            // running reached 0
+
+        // checkpoints (of a single job)
+        uint64_t fingerprint;
+        unsigned long long num_chunks;      // of every job
+        pthread_mutex_t commit_lock;
+        struct stats_t *committed;          // per worker and strategy
+        unsigned char *done;
+        unsigned char *skip;
+        unsigned char *saved;               // copy of 'done' to save
+        struct stats_t base[SIM_MAX_STRATEGIES];    // from the checkpoint
+};
+
+
+
+// Return TRUE if bit 'chunk' of a chunk bitmap is set.
+static inline int chunk_bit(const unsigned char *bitmap,
+                            unsigned long long chunk)
+{
+        return (bitmap[chunk / 8] >> (chunk % 8)) & 1;
+} // chunk_bit()
+
+
+
+// Round a size up to whole arena blocks.
+static size_t arena_blocks(size_t size)
+{
+        return (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+} // arena_blocks()
+
+
+
+// Start a chunk's shoe in the configured dealing mode.
+static void start_shoe(const struct sim_config_t *config,
+                       struct shoe_t *shoe, uint64_t seed)
+{
+        switch (config->mode) {
+                case SHOE_INFINITE:
+                        shoe_init_infinite(shoe, seed);
+                        break;
+                case SHOE_FIXED:
+                        shoe_init_counts(shoe, config->composition, seed);
+                        break;
+                case SHOE_CSM:
+                        shoe_init_csm(shoe, config->decks,
+                                      config->csm_buffer, seed);
+                        break;
+                default:
+                        shoe_init(shoe, config->decks, seed);
+                        shoe_set_shuffle(shoe, config->shuffle,
+                                         config->penetration);
+                        break;
+        }
+} // start_shoe()
+
+
+
+// Pin a worker (if it is placed) and allocate what it plays each job
+// with on its own thread. A worker that cannot be pinned plays
+// unpinned. Returns SUCCESS or -1.
+static int worker_setup(struct worker_t *w)
+{
+        const struct sim_config_t *config;
+        struct seat_t *seat;
+        size_t size = 0;
+
+        for (int j = 0; j < w->num_jobs; ++j) {
+                config = w->jobs[j].config;
+                size += session_arena_size(1) +
+                        stats_arena_size(w->jobs[j].num_strategies);
+                if (config->export != NULL) {
+                        size += arena_blocks(sizeof(struct export_record_t));
+                }
+        }
+        if (w->cpu >= 0 && numa_pin(w->cpu) != SUCCESS) {
+                w->cpu = -1;
+        }
+        if (arena_init(&w->arena, size) != SUCCESS) {
+                return -1;
+        }
+
+        for (int j = 0; j < w->num_jobs; ++j) {
+                config = w->jobs[j].config;
+                seat = &w->seats[j];
+                seat->accs = arena_alloc(&w->arena, stats_arena_size(
+                                                 w->jobs[j].num_strategies));
+                seat->session = session_create(&w->arena, config->decks,
+                                               config->seed);
+                seat->record = NULL;
+                if (config->export != NULL) {
+                        seat->record = arena_alloc(&w->arena,
+                                                   sizeof(*seat->record));
+                }
+                if (seat->accs == NULL || seat->session == NULL ||
+                    (config->export != NULL && seat->record == NULL)) {
+                        return -1;
+                }
+                session_set_rules(seat->session, &config->rules);
+                if (seat->record != NULL) {
+                        session_set_table(seat->session,
+                                          &seat->record->table);
+                }
+        }
+
+        return SUCCESS;
+} // worker_setup()
+
+
+
+static double elapsed_seconds(const struct timespec *start)
+{
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (now.tv_sec - start->tv_sec) +
+               (now.tv_nsec - start->tv_nsec) / 1e9;
+} // elapsed_seconds()
+
+
+
+// Count the worker out of the run, waking the monitor if it was the
+// last one.
+static void worker_done(struct worker_t *w)
+{
+        pthread_mutex_lock(w->done_lock);
+        if (atomic_fetch_sub(w->running, 1) == 1) {
+                pthread_cond_signal(w->all_done);
+        }
+        pthread_mutex_unlock(w->done_lock);
+} // worker_done()
+
+
+
+// Play chunk 'chunk' of a job (in the job's own numbering) once per
+// strategy. Returns the hands played.
+static unsigned long long play_chunk(const struct job_t *job,
+                                     struct seat_t *seat,
+                                     unsigned long long chunk)
+{
+        const struct sim_config_t *config = job->config;
+        struct session_t *session = seat->session;
+        const struct engine_t *engine;
+        unsigned long long first;
+        unsigned long long count;
+        unsigned long long half;
+        int64_t payoff;
+        int64_t control;
+        int64_t base_payoff = 0;
+        uint64_t seed;
+
+        // the last chunk may be short
+        first = chunk * config->chunk;
+        count = config->hands - first;
+        if (count > config->chunk) {
+                count = config->chunk;
+        }
+
+        // every strategy plays the chunk from the same shoe
+        seed = rng_stream_seed(config->seed, chunk);
+        half = config->antithetic ? count / 2 : count;
+        for (int s = 0; s < job->num_strategies; ++s) {
+                session_set_strategy(session, config->strategies[s]);
+                session_set_sidebets(session,
+                                     s == 0 ? config->sidebets : 0);
+                session_set_control(session, job->controls == NULL ?
+                                             NULL : &job->controls[s]);
+                if (seat->record != NULL) {
+                        stats_table_clear(&seat->record->table);
+                }
+                start_shoe(config, &session->shoe, seed);
+                payoff = 0;
+                control = 0;
+                // the engine follows the strategy and side bets
+                engine = session->engine;
+                engine->play_run(session, half, &seat->accs[s], &payoff,
+                                 &control);
+                if (half < count) {
+                        // antithetic twin of the first half
+                        start_shoe(config, &session->shoe, seed);
+                        shoe_reflect(&session->shoe);
+                        engine->play_run(session, count - half,
+                                         &seat->accs[s], &payoff, &control);
+                }
+                if (s == 0) {
+                        base_payoff = payoff;
+                }
+                stats_acc_end_batch(&seat->accs[s], payoff, control,
+                                    payoff - base_payoff);
+                if (seat->record != NULL) {
+                        seat->record->batch = chunk;
+                        seat->record->strategy = s;
+                        export_submit(config->export, seat->record);
+                }
+        }
+
+        return count * job->num_strategies;
+} // play_chunk()
+
+
+
+static void *worker_main(void *arg)
+{
+        struct worker_t *w = arg;
+        const struct job_t *job;
+        struct timespec start;
+        unsigned long long chunk;
+        int j;
+
+        w->ok = worker_setup(w) == SUCCESS;
+        sem_post(w->ready);
+        if (!w->ok) {
+                worker_done(w);
+                return NULL;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (;;) {
+                chunk = atomic_fetch_add_explicit(w->next_chunk, 1,
+                                                  memory_order_relaxed);
+                if (chunk >= w->num_chunks) {
+                        break;
+                }
+
+                // find the job the chunk belongs to
+                j = 0;
+                while (chunk >= w->jobs[j].first_chunk +
+                                w->jobs[j].num_chunks) {
+                        ++j;
+                }
+                job = &w->jobs[j];
+                chunk -= job->first_chunk;
+                if (w->skip != NULL && chunk_bit(w->skip, chunk)) {
+                        continue;
+                }
+
+                w->hands += play_chunk(job, &w->seats[j], chunk);
+
+                if (w->done != NULL) {
+                        // publish the totals for checkpoints
+                        pthread_mutex_lock(w->commit_lock);
+                        for (int s = 0; s < job->num_strategies; ++s) {
+                                w->committed[s] = w->seats[j].accs[s].totals;
+                        }
+                        w->done[chunk / 8] |= 1 << (chunk % 8);
+                        pthread_mutex_unlock(w->commit_lock);
+                }
+        }
+        w->seconds = elapsed_seconds(&start);
+        worker_done(w);
+
+        return NULL;
+} // worker_main()
+
+
+
+// Wait up to 'ms' milliseconds for every worker to be done. Returns
+// TRUE if they are.
+static int wait_done(struct run_t *run, int ms)
+{
+        struct timespec until;
+        int done;
+
+        clock_gettime(CLOCK_MONOTONIC, &until);
+        until.tv_sec += ms / 1000;
+        until.tv_nsec += (long)(ms % 1000) * 1000000L;
+        if (until.tv_nsec >= 1000000000L) {
+                ++until.tv_sec;
+                until.tv_nsec -= 1000000000L;
+        }
+
+        pthread_mutex_lock(&run->done_lock);
+        while (atomic_load(&run->running) > 0 &&
+               pthread_cond_timedwait(&run->all_done, &run->done_lock,
+                                      &until) != ETIMEDOUT) {
+                // woken early (or spuriously): look again
+        }
+        done = atomic_load(&run->running) == 0;
+        pthread_mutex_unlock(&run->done_lock);
+
+        return done;
+} // wait_done()
+
+
+
+extern void sim_config_default(struct sim_config_t *config)
+{
+        config->hands = 1000000;
+        config->chunk = SIM_DEFAULT_CHUNK;
+        config->threads = 1;
+        config->decks = 1;
+        config->mode = SHOE_DECKS;
+        rules_default(&config->rules);
+        memset(config->composition, 0, sizeof(config->composition));
+        config->shuffle[0] = '\0';
+        config->penetration = 0;
+        config->csm_buffer = 0;
+        config->seed = 1;
+        config->interval_ms = 0;
+        config->antithetic = FALSE;
+        config->control = FALSE;
+        config->num_strategies = 0;
+        config->export = NULL;
+        config->checkpoint = NULL;
+        config->checkpoint_ms = 60000;
+        config->resume = FALSE;
+        config->progress = NULL;
+        config->progress_arg = NULL;
+        config->numa = FALSE;
+        config->nodes = NULL;
+        config->sidebets = 0;
+        config->side = NULL;
+} // sim_config_default()
+
+
+
+// Merge the accumulators of each strategy of job 'j' over the workers.
+static void snapshot(struct run_t *run, int j, struct stats_t *totals)
+{
+        int num_strategies = run->jobs[j].num_strategies;
+        struct stats_t one;
+
+        // (only a single job resumes from a checkpoint)
+        for (int s = 0; s < num_strategies; ++s) {
+                totals[s] = run->base[s];
+        }
+        for (int i = 0; i < run->num_workers; ++i) {
+                for (int s = 0; s < num_strategies; ++s) {
+                        stats_acc_read(&run->workers[i].seats[j].accs[s],
+                                       &one);
+                        stats_merge(&totals[s], &one);
+                }
+        }
+} // snapshot()
+
+
+
+// Save what the workers have published so far. Returns SUCCESS or -1.
+static int save_checkpoint(struct run_t *run,
+                           const struct sim_config_t *config,
+                           int num_strategies)
+{
+        struct stats_t totals[SIM_MAX_STRATEGIES];
+        struct checkpoint_t cp;
+
+        for (int s = 0; s < num_strategies; ++s) {
+                totals[s] = run->base[s];
+        }
+        pthread_mutex_lock(&run->commit_lock);
+        for (int i = 0; i < config->threads * num_strategies; ++i) {
+                stats_merge(&totals[i % num_strategies], &run->committed[i]);
+        }
+        memcpy(run->saved, run->done, CHECKPOINT_DONE_SIZE(run->num_chunks));
+        pthread_mutex_unlock(&run->commit_lock);
+
+        // the file is written with the workers running on
+        cp.fingerprint = run->fingerprint;
+        cp.num_chunks = run->num_chunks;
+        cp.num_strategies = num_strategies;
+        cp.totals = totals;
+        cp.done = run->saved;
+
+        return checkpoint_save(config->checkpoint, &cp);
+} // save_checkpoint()
+
+
+
+static void monitor(struct run_t *run, const struct sim_config_t *config,
+                    int num_strategies)
+{
+        struct stats_t live[SIM_MAX_STRATEGIES];
+        int progress = config->progress != NULL && config->interval_ms > 0;
+        int tick = config->checkpoint_ms;
+        int since_checkpoint = 0;
+
+        if (progress && (config->checkpoint == NULL ||
+                         config->interval_ms < tick)) {
+                tick = config->interval_ms;
+        }
+
+        // report live totals and save checkpoints until every worker is
+        // done (the last one wakes us, and sim_run() saves the final
+        // checkpoint); a checkpoint that fails is simply tried again next
+        // time
+        while (!wait_done(run, tick)) {
+                if (progress) {
+                        snapshot(run, 0, live);
+                        config->progress(live, num_strategies,
+                                         config->progress_arg);
+                }
+                since_checkpoint += tick;
+                if (config->checkpoint != NULL &&
+                    since_checkpoint >= config->checkpoint_ms) {
+                        save_checkpoint(run, config, num_strategies);
+                        since_checkpoint = 0;
+                }
+        }
+} // monitor()
+
+
+
+// Hash everything in a configuration that changes the results, so a
+// checkpoint is only resumed by the run it came from. The number of
+// threads does not change the results.
+static uint64_t fingerprint(const struct sim_config_t *config,
+                            int num_strategies)
+{
+        uint64_t h = CHECKPOINT_HASH_INIT;
+        const unsigned char dealer = 0;
+
+        h = checkpoint_hash(h, &config->hands, sizeof(config->hands));
+        h = checkpoint_hash(h, &config->chunk, sizeof(config->chunk));
+        h = checkpoint_hash(h, &config->seed, sizeof(config->seed));
+        h = checkpoint_hash(h, &config->decks, sizeof(config->decks));
+        h = checkpoint_hash(h, &config->mode, sizeof(config->mode));
+        h = checkpoint_hash(h, config->composition,
+                            sizeof(config->composition));
+        h = checkpoint_hash(h, config->shuffle, strlen(config->shuffle));
+        h = checkpoint_hash(h, &config->penetration,
+                            sizeof(config->penetration));
+        h = checkpoint_hash(h, &config->csm_buffer,
+                            sizeof(config->csm_buffer));
+        h = checkpoint_hash(h, &config->rules, sizeof(config->rules));
+        h = checkpoint_hash(h, &config->antithetic,
+                            sizeof(config->antithetic));
+        h = checkpoint_hash(h, &config->control, sizeof(config->control));
+        for (int s = 0; s < num_strategies; ++s) {
+                if (config->strategies[s] == NULL) {
+                        h = checkpoint_hash(h, &dealer, sizeof(dealer));
+                } else {
+                        h = checkpoint_hash(h, config->strategies[s],
+                                            sizeof(struct strategy_t));
+                }
+        }
+
+        return h;
+} // fingerprint()
+
+
+
+// Build the control table of each strategy of a job for the shoe a
+// chunk starts from. Returns SUCCESS or -1.
+static int start_controls(struct run_t *run, struct job_t *job)
+{
+        const struct sim_config_t *config = job->config;
+        struct shoe_t full;
+
+        job->controls = arena_alloc(&run->arena,
+                                    sizeof(struct control_table_t) *
+                                    job->num_strategies);
+        if (job->controls == NULL) {
+                return -1;
+        }
+        start_shoe(config, &full, config->seed);
+        for (int s = 0; s < job->num_strategies; ++s) {
+                control_compute(&job->controls[s], &config->rules,
+                                config->strategies[s], full.full);
+        }
+
+        return SUCCESS;
+} // start_controls()
+
+
+
+// Set up the checkpoint state of a run, loading the checkpoint to
+// resume from if there is one. Returns SUCCESS or -1.
+static int start_checkpoints(struct run_t *run,
+                             const struct sim_config_t *config,
+                             int num_strategies)
+{
+        size_t bitmap_size = CHECKPOINT_DONE_SIZE(run->num_chunks);
+        struct checkpoint_t cp;
+
+        run->committed = arena_alloc(&run->arena, sizeof(struct stats_t) *
+                                     config->threads * num_strategies);
+        run->done = arena_alloc(&run->arena, bitmap_size);
+        run->skip = arena_alloc(&run->arena, bitmap_size);
+        run->saved = arena_alloc(&run->arena, bitmap_size);
+        if (run->committed == NULL || run->done == NULL ||
+            run->skip == NULL || run->saved == NULL) {
+                return -1;
+        }
+        run->fingerprint = fingerprint(config, num_strategies);
+
+        if (config->resume) {
+                cp.fingerprint = run->fingerprint;
+                cp.num_chunks = run->num_chunks;
+                cp.num_strategies = num_strategies;
+                cp.totals = run->base;
+                cp.done = run->skip;
+                if (checkpoint_load(config->checkpoint, &cp) != SUCCESS) {
+                        return -1;
+                }
+                memcpy(run->done, run->skip, bitmap_size);
+        }
+
+        return SUCCESS;
+} // start_checkpoints()
+
+
+
+// Add up the hands played on each node, and the longest time any of
+// its workers played (all on one node unless the run was placed).
+static void report_nodes(struct run_t *run,
+                         const struct sim_config_t *config,
+                         const struct numa_t *numa)
+{
+        struct sim_nodes_t *nodes = config->nodes;
+
+        nodes->num_nodes = config->numa ? numa->num_nodes : 1;
+        for (int n = 0; n < nodes->num_nodes; ++n) {
+                nodes->node[n].id = config->numa ? numa->node_id[n] : -1;
+                nodes->node[n].workers = 0;
+                nodes->node[n].hands = 0;
+                nodes->node[n].seconds = 0;
+                nodes->node[n].unpinned = 0;
+        }
+        for (int i = 0; i < run->num_workers; ++i) {
+                const struct worker_t *w = &run->workers[i];
+                struct sim_node_t *node = &nodes->node[w->node];
+
+                ++node->workers;
+                node->hands += w->hands;
+                node->unpinned += config->numa && w->cpu < 0;
+                if (w->seconds > node->seconds) {
+                        node->seconds = w->seconds;
+                }
+        }
+} // report_nodes()
+
+
+
+// Add up the side bets of job 'j' and work out their exact values for
+// the shoe a chunk starts from.
+static void report_side(struct run_t *run, int j)
+{
+        const struct sim_config_t *config = run->jobs[j].config;
+        struct sim_side_t *side = config->side;
+        struct shoe_t full;
+
+        memset(&side->totals, 0, sizeof(side->totals));
+        for (int i = 0; i < run->num_workers; ++i) {
+                sidebet_merge(&side->totals,
+                              &run->workers[i].seats[j].session->side);
+        }
+        start_shoe(config, &full, config->seed);
+        sidebet_exact(&full, side->exact);
+} // report_side()
+
+
+
+// Check the configuration of a job. Returns SUCCESS or -1.
+static int check_config(const struct sim_config_t *config)
+{
+        struct shoe_t check;
+        size_t size;
+
+        if (config->threads < 1 || config->threads > SIM_MAX_THREADS ||
+            config->decks < 1 || config->decks > MAX_DECKS ||
+            config->chunk < 1 || config->num_strategies < 0 ||
+            config->mode < SHOE_DECKS || config->mode > SHOE_CSM ||
+            config->num_strategies > SIM_MAX_STRATEGIES ||
+            (config->checkpoint != NULL && config->checkpoint_ms < 1) ||
+            (config->resume && config->checkpoint == NULL) ||
+            config->sidebets < 0 || config->sidebets > SIDEBET_ALL ||
+            (config->sidebets != 0 && (config->resume ||
+                                       config->side == NULL))) {
+                return -1;
+        }
+        if (config->mode == SHOE_DECKS) {
+                // check the shuffle on a shoe like the ones to be played
+                shoe_init(&check, config->decks, 0);
+                if (shoe_set_shuffle(&check, config->shuffle,
+                                     config->penetration) != SUCCESS) {
+                        return -1;
+                }
+        }
+        if (config->mode == SHOE_CSM &&
+            shoe_init_csm(&check, config->decks, config->csm_buffer,
+                          0) != SUCCESS) {
+                return -1;
+        }
+        if (config->mode == SHOE_FIXED) {
+                size = 0;
+                for (int m = ACE; m <= KING; ++m) {
+                        size += config->composition[m];
+                }
+                if (size == 0 || size > MAX_SHOE_CARDS) {
+                        return -1;
+                }
+                // an antithetic twin has to play the same shoe
+                if (config->antithetic &&
+                    !shoe_reflect_keeps(config->composition)) {
+                        return -1;
+                }
+        }
+
+        return SUCCESS;
+} // check_config()
+
+
+
+extern int sim_run_jobs(const struct sim_config_t *const *jobs,
+                        int num_jobs, struct stats_t *const *totals)
+{
+        struct run_t run;
+        struct numa_t numa;
+        const struct sim_config_t *config;
+        pthread_condattr_t attr;
+        int num_strategies;
+        int result = SUCCESS;
+        int started = 0;
+        size_t size;
+
+        if (num_jobs < 1 || num_jobs > SIM_MAX_JOBS) {
+                return -1;
+        }
+        for (int j = 0; j < num_jobs; ++j) {
+                if (check_config(jobs[j]) != SUCCESS ||
+                    (num_jobs > 1 && (jobs[j]->checkpoint != NULL ||
+                                      jobs[j]->progress != NULL))) {
+                        return -1;
+                }
+        }
+
+        // number the chunks of the jobs one after the other
+        run.num_jobs = num_jobs;
+        run.num_chunks = 0;
+        for (int j = 0; j < num_jobs; ++j) {
+                struct job_t *job = &run.jobs[j];
+
+                job->config = jobs[j];
+                job->num_strategies = jobs[j]->num_strategies;
+                if (job->num_strategies == 0) {
+                        // play one run with the dealer's strategy
+                        job->dealer_only = *jobs[j];
+                        job->dealer_only.strategies[0] = NULL;
+                        job->dealer_only.num_strategies = 1;
+                        job->config = &job->dealer_only;
+                        job->num_strategies = 1;
+                }
+                job->first_chunk = run.num_chunks;
+                job->num_chunks = (jobs[j]->hands + jobs[j]->chunk - 1) /
+                                  jobs[j]->chunk;
+                job->controls = NULL;
+                run.num_chunks += job->num_chunks;
+        }
+
+        // the first job places the workers and has the checkpoints and
+        // progress calls
+        config = run.jobs[0].config;
+        num_strategies = run.jobs[0].num_strategies;
+        if (config->numa && numa_discover(&numa) != SUCCESS) {
+                return -1;
+        }
+
+        // the run's arena holds the control tables and the checkpoint
+        // state (the workers have arenas of their own)
+        size = ARENA_ALIGN;
+        for (int j = 0; j < num_jobs; ++j) {
+                if (run.jobs[j].config->control) {
+                        size += arena_blocks(sizeof(struct control_table_t) *
+                                             run.jobs[j].num_strategies);
+                }
+        }
+        if (config->checkpoint != NULL) {
+                size += arena_blocks(sizeof(struct stats_t) *
+                                     config->threads * num_strategies) +
+                        3 * arena_blocks(CHECKPOINT_DONE_SIZE(
+                                                 run.num_chunks));
+        }
+        if (arena_init(&run.arena, size) != SUCCESS) {
+                return -1;
+        }
+        memset(run.base, 0, sizeof(run.base));
+        run.committed = NULL;
+        run.done = NULL;
+        run.skip = NULL;
+        pthread_mutex_init(&run.commit_lock, NULL);
+        pthread_mutex_init(&run.done_lock, NULL);
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&run.all_done, &attr);
+        pthread_condattr_destroy(&attr);
+        for (int j = 0; j < num_jobs && result == SUCCESS; ++j) {
+                if (run.jobs[j].config->control &&
+                    start_controls(&run, &run.jobs[j]) != SUCCESS) {
+                        result = -1;
+                }
+        }
+        if (result == SUCCESS && config->checkpoint != NULL &&
+            start_checkpoints(&run, config, num_strategies) != SUCCESS) {
+                result = -1;
+        }
+
+        atomic_store(&run.next_chunk, 0);
+        for (int i = 0; i < config->threads && result == SUCCESS; ++i) {
+                struct worker_t *w = &run.workers[i];
+
+                w->jobs = run.jobs;
+                w->num_jobs = num_jobs;
+                w->next_chunk = &run.next_chunk;
+                w->running = &run.running;
+                w->num_chunks = run.num_chunks;
+                w->done_lock = &run.done_lock;
+                w->all_done = &run.all_done;
+                w->commit_lock = &run.commit_lock;
+                w->committed = NULL;
+                if (run.committed != NULL) {
+                        w->committed = &run.committed[i * num_strategies];
+                }
+                w->done = run.done;
+                w->skip = config->resume ? run.skip : NULL;
+                w->arena.base = NULL;
+                memset(w->seats, 0, sizeof(w->seats));
+                w->node = 0;
+                w->cpu = -1;
+                if (config->numa) {
+                        w->node = numa_place(&numa, i, &w->cpu);
+                }
+                w->ok = FALSE;
+                w->ready = &run.ready;
+                w->hands = 0;
+                w->seconds = 0;
+        }
+
+        sem_init(&run.ready, 0, 0);
+        run.num_workers = 0;
+        atomic_store(&run.running, 0);
+        for (int i = 0; i < config->threads && result == SUCCESS; ++i) {
+                atomic_fetch_add(&run.running, 1);
+                if (pthread_create(&run.threads[i], NULL, worker_main,
+                                   &run.workers[i]) != 0) {
+                        atomic_fetch_sub(&run.running, 1);
+                        result = -1;
+                } else {
+                        ++started;
+                        sem_wait(&run.ready);
+                        if (run.workers[i].ok) {
+                                run.num_workers = i + 1;
+                        } else {
+                                result = -1;
+                        }
+                }
+                if (result != SUCCESS) {
+                        // stop handing out chunks; the others finish up
+                        atomic_store(&run.next_chunk, ~0ULL >> 1);
+                }
+        }
+
+        if (result == SUCCESS && (config->checkpoint != NULL ||
+                                  (config->progress != NULL &&
+                                   config->interval_ms > 0))) {
+                monitor(&run, config, num_strategies);
+        }
+
+        for (int i = 0; i < started; ++i) {
+                pthread_join(run.threads[i], NULL);
+        }
+
+        if (result == SUCCESS && config->checkpoint != NULL &&
+            save_checkpoint(&run, config, num_strategies) != SUCCESS) {
+                result = -1;
+        }
+        for (int j = 0; j < num_jobs; ++j) {
+                snapshot(&run, j, totals[j]);
+                if (run.jobs[j].config->side != NULL) {
+                        report_side(&run, j);
+                }
+        }
+        if (config->nodes != NULL) {
+                report_nodes(&run, config, &numa);
+        }
+        for (int i = 0; i < started; ++i) {
+                arena_free(&run.workers[i].arena);
+        }
+        sem_destroy(&run.ready);
+        pthread_mutex_destroy(&run.commit_lock);
+        pthread_mutex_destroy(&run.done_lock);
+        pthread_cond_destroy(&run.all_done);
+        arena_free(&run.arena);
+
+        return result;
+} // sim_run_jobs()
+
+
+
+extern int sim_run(const struct sim_config_t *config,
+                   struct stats_t *totals)
+{
+        return sim_run_jobs(&config, 1, &totals);
+} // sim_run()
+
+
+// end of sim.c
@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------
+// file: sim.h
+//
+// Description: This is the header file for the SIM module, the headless
+//     multi-threaded simulator. A run is split into chunks of hands;
+//     every chunk is played from a shoe seeded only by the run seed and
+//     the chunk number, so the results do not depend on how many
+//     threads run or which thread plays which chunk.
+//
+//     A run may compare several strategies. Each chunk is then played
+//     once per strategy from the same shoe (common random numbers), so
+//     the differences between the strategies' results come from their
+//     decisions and not from different cards.
+//
+//     Each chunk is one batch for the batch-means estimators. With
+//     antithetic shoes the second half of every chunk replays the first
+//     half's shoe reflected (see shoe_reflect()), so the two halves are
+//     negatively correlated and the chunk stays one independent batch.
+//     A fixed composition has to be symmetric under the reflection for
+//     antithetic shoes (see shoe_reflect_keeps()).
+//
+//     With the control variate every strategy plays with a control
+//     table (see control.h) built for it from the composition of the
+//     full shoe; without it the control of every hand is 0.
+//
+//     A shoe of decks keeps its order from one shuffle to the next for
+//     the whole chunk, so a shuffle procedure (see shoe_set_shuffle())
+//     that does not fully randomize the cards affects the results.
+//
+//     Several runs can share one pool of workers as the jobs of one
+//     call (see sim_run_jobs()). Their chunks are handed out one at a
+//     time from a single counter, so workers stay busy to the end even
+//     when a chunk of one job costs many times a chunk of another (one
+//     deck against eight, a strategy against the dealer's, the control
+//     variate or not). Each job keeps its own chunk numbers and seeds,
+//     and ends with the same totals as it does run alone.
+//
+//     Long runs can save checkpoints (see checkpoint.h) from the calling
+//     thread while the workers keep going: each worker publishes its
+//     totals whenever it finishes a chunk, and a checkpoint copies what
+//     has been published. A run resumed from a checkpoint skips the
+//     chunks it records and ends with the same totals, bit for bit, as
+//     a run that was never stopped.
+//
+//     On a NUMA machine the workers can be pinned to CPUs spread over
+//     the nodes (see numa.h), each with its shoe, random number
+//     generator and accumulators in memory on its own node, and the
+//     hands played on each node reported, to check that the run scales
+//     across sockets. Pinning only helps: a worker that cannot be pinned
+//     (a changed cpuset, a restricted container) plays unpinned and is
+//     counted in the report.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "card.h"
+#include "engine.h"
+#include "stats.h"
+#include "strategy.h"
+#include "export.h"
+#include "numa.h"
+#include "sidebet.h"
+
+#define SIM_DEFAULT_CHUNK 100000
+#define SIM_MAX_THREADS 256
+#define SIM_MAX_STRATEGIES 32
+#define SIM_MAX_JOBS 16
+
+// Hands played on one NUMA node.
+struct sim_node_t {
+        int id;                     // the kernel's node number (-1: any)
+        int workers;
+        unsigned long long hands;   // once per strategy
+        double seconds;             // the longest a worker there played
+        int unpinned;               // workers that could not be pinned
+};
+
+struct sim_nodes_t {
+        int num_nodes;
+        struct sim_node_t node[NUMA_MAX_NODES];
+};
+
+// Side bets of a run and their exact values for a full shoe.
+struct sim_side_t {
+        struct sidebet_totals_t totals;
+        double exact[SIDEBET_KINDS];
+};
+
+struct sim_config_t {
+        unsigned long long hands;   // hands to play in total
+        unsigned long chunk;        // hands per chunk
+        int threads;                // worker threads
+        int decks;                  // decks per shoe
+        int mode;                   // SHOE_DECKS, _INFINITE, _FIXED, _CSM
+        unsigned short composition[KING + 1];  // cards for SHOE_FIXED
+        char shuffle[SHUFFLE_MAX_STEPS + 1];   // procedure for SHOE_DECKS
+        int penetration;            // cards dealt before the cut card
+        int csm_buffer;             // cards ready to deal in a SHOE_CSM
+        struct rules_t rules;       // picks the specialized engine
+        uint64_t seed;              // run seed
+        int interval_ms;            // period of progress calls (0 = none)
+        int antithetic;             // TRUE: antithetic half chunks
+        int control;                // TRUE: add up the control variate
+
+        // Strategies to play (NULL entries play like the dealer). With
+        // no strategies one run of the dealer's strategy is made.
+        const struct strategy_t *strategies[SIM_MAX_STRATEGIES];
+        int num_strategies;
+
+        // If set, every batch of every strategy is exported, broken
+        // down by starting hand and up card.
+        struct export_t *export;
+
+        // If 'checkpoint' is set, the run's progress is saved there
+        // every checkpoint_ms and when it ends. With 'resume' the run
+        // first loads that file and only plays the chunks left.
+        const char *checkpoint;
+        int checkpoint_ms;
+        int resume;
+
+        // Called from the monitoring thread every interval_ms with live
+        // totals (one per strategy) while the workers run.
+        void (*progress)(const struct stats_t *live, int num, void *arg);
+        void *progress_arg;
+
+        // TRUE: pin the workers to CPUs spread over the NUMA nodes. If
+        // 'nodes' is set, the hands played on each node (on one node
+        // without 'numa') are stored there.
+        int numa;
+        struct sim_nodes_t *nodes;
+
+        // Side bets (a mask, see sidebet.h) placed on every hand of the
+        // first strategy; their results are stored in 'side'. They are
+        // not saved in checkpoints, so they cannot be resumed.
+        int sidebets;
+        struct sim_side_t *side;
+};
+
+
+// Fill in the default configuration.
+extern void sim_config_default(struct sim_config_t *config);
+
+
+// Run a simulation and store the final results of each strategy in
+// 'totals', which must have room for max(1, num_strategies) entries.
+// Returns SUCCESS or -1 if the configuration is invalid, resources
+// could not be obtained, the checkpoint to resume from could not be
+// loaded (errno tells why) or the final checkpoint could not be saved.
+extern int sim_run(const struct sim_config_t *config,
+                   struct stats_t *totals);
+
+
+// Run the 'num_jobs' (1..SIM_MAX_JOBS) simulations 'jobs' in one pool
+// of workers and store the final results of each strategy of job j in
+// 'totals[j]', as sim_run() does. The first job sets the threads and
+// their placement ('threads', 'numa' and 'nodes'); the others' are
+// ignored. Checkpoints and progress calls are only for a single job.
+// Returns SUCCESS or -1 as sim_run() does.
+extern int sim_run_jobs(const struct sim_config_t *const *jobs,
+                        int num_jobs, struct stats_t *const *totals);
+
+#endif
+// end of sim.h
@@ -0,0 +1,291 @@
+// ----------------------------------------------------------------------
+// file: stats.c
+//
+// Description: This file implements the STATS module. The writer side
+//     of the seqlock is inline in stats.h; the reader side is here.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <string.h>
+#include <math.h>
+#include "common.h"
+#include "stats.h"
+
+
+extern void stats_clear(struct stats_t *stats)
+{
+        memset(stats, 0, sizeof(*stats));
+} // stats_clear()
+
+
+
+extern void stats_merge(struct stats_t *dst, const struct stats_t *src)
+{
+        dst->hands += src->hands;
+        dst->wins += src->wins;
+        dst->losses += src->losses;
+        dst->draws += src->draws;
+        dst->payoff += src->payoff;
+        dst->payoff_sq += src->payoff_sq;
+        dst->control += src->control;
+        dst->control_sq += src->control_sq;
+        dst->control_payoff += src->control_payoff;
+        dst->batches += src->batches;
+        dst->batch_payoff_sq += src->batch_payoff_sq;
+        dst->batch_control_sq += src->batch_control_sq;
+        dst->batch_control_payoff += src->batch_control_payoff;
+        dst->batch_diff_sq += src->batch_diff_sq;
+} // stats_merge()
+
+
+
+extern double stats_ev(const struct stats_t *stats)
+{
+        double ev = 0.0;
+
+        if (stats->hands > 0) {
+                ev = (double)stats->payoff / 2.0 / (double)stats->hands;
+        }
+
+        return ev;
+} // stats_ev()
+
+
+
+extern double stats_variance(const struct stats_t *stats)
+{
+        double ev;
+        double var = 0.0;
+
+        if (stats->hands > 1) {
+                ev = stats_ev(stats);
+                var = (double)stats->payoff_sq / 4.0 / (double)stats->hands;
+                var = (var - ev * ev) * (double)stats->hands /
+                      (double)(stats->hands - 1);
+        }
+
+        return var;
+} // stats_variance()
+
+
+
+// 95% two-sided normal quantile
+#define Z_95 1.959963984540054
+
+// 95% two-sided quantiles of Student's t by degrees of freedom
+#define T_95_TABLE 30
+static const double T_95[T_95_TABLE + 1] = {
+        0.0, 12.7062047, 4.3026527, 3.1824463, 2.7764451, 2.5705818,
+        2.4469119, 2.3646243, 2.3060041, 2.2621572, 2.2281389, 2.2009852,
+        2.1788128, 2.1603687, 2.1447867, 2.1314495, 2.1199053, 2.1098156,
+        2.1009220, 2.0930241, 2.0859634, 2.0796138, 2.0738731, 2.0686576,
+        2.0638986, 2.0595386, 2.0555294, 2.0518305, 2.0484071, 2.0452296,
+        2.0422725
+};
+
+
+
+// Return the 95% two-sided quantile of Student's t with 'df' (1 or
+// more) degrees of freedom: from the table, then from the
+// Cornish-Fisher expansion around the normal quantile, which is good to
+// a few millionths beyond it.
+static double t_95(double df)
+{
+        double z = Z_95;
+        double z2 = z * z;
+
+        if (df <= T_95_TABLE) {
+                return T_95[(int)df];
+        }
+        return z + z * (z2 + 1) / (4 * df) +
+               z * ((5 * z2 + 16) * z2 + 3) / (96 * df * df) +
+               z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) /
+               (384 * df * df * df);
+} // t_95()
+
+
+
+// Control-variate regression on n samples of y with a control x of
+// known mean zero, given the raw sums. Stores the adjusted mean of y
+// and the variance of one adjusted sample.
+static void regress(double n, double sy, double syy, double sx, double sxx,
+                    double sxy, double *mean, double *var)
+{
+        double vy = (syy - sy * sy / n) / (n - 1);
+        double vx = (sxx - sx * sx / n) / (n - 1);
+        double cxy = (sxy - sx * sy / n) / (n - 1);
+        double beta = 0.0;
+
+        if (vx > 0.0) {
+                beta = cxy / vx;
+        }
+        *mean = (sy - beta * sx) / n;
+        *var = vy - beta * cxy;
+        if (*var < 0.0) {
+                *var = 0.0;
+        }
+} // regress()
+
+
+
+extern int stats_estimate(const struct stats_t *stats, int method,
+                          struct estimate_t *est)
+{
+        double n = (double)stats->hands;
+        double b = (double)stats->batches;
+        double mean;
+        double var;
+        int result = SUCCESS;
+
+        if (stats->hands < 2 ||
+            (method == STATS_BATCH && stats->batches < 2) ||
+            (method == STATS_BATCH_CONTROL && stats->batches < 3)) {
+                return -1;
+        }
+
+        switch (method) {
+                case STATS_CONTROL:
+                        // per hand, in half bets
+                        regress(n, stats->payoff, stats->payoff_sq,
+                                stats->control, stats->control_sq,
+                                stats->control_payoff, &mean, &var);
+                        est->ev = mean / 2.0;
+                        est->half_width = Z_95 * sqrt(var / n) / 2.0;
+                        break;
+                case STATS_BATCH:
+                        // per batch: the variance of a batch total
+                        // gives the variance of the grand total
+                        var = (stats->batch_payoff_sq -
+                               (double)stats->payoff * stats->payoff / b) /
+                              (b - 1);
+                        est->ev = stats->payoff / n / 2.0;
+                        est->half_width = t_95(b - 1) * sqrt(var * b) /
+                                          n / 2.0;
+                        break;
+                case STATS_BATCH_CONTROL:
+                        // the slope costs a degree of freedom
+                        regress(b, stats->payoff, stats->batch_payoff_sq,
+                                stats->control, stats->batch_control_sq,
+                                stats->batch_control_payoff, &mean, &var);
+                        var = var * (b - 1) / (b - 2);
+                        est->ev = mean * b / n / 2.0;
+                        est->half_width = t_95(b - 2) * sqrt(var * b) /
+                                          n / 2.0;
+                        break;
+                case STATS_PLAIN:
+                        est->ev = stats_ev(stats);
+                        est->half_width = Z_95 *
+                                          sqrt(stats_variance(stats) / n);
+                        break;
+                default:
+                        result = -1;
+                        break;
+        }
+
+        return result;
+} // stats_estimate()
+
+
+
+extern int stats_estimate_diff(const struct stats_t *stats,
+                               const struct stats_t *base,
+                               struct estimate_t *est)
+{
+        double n = (double)stats->hands;
+        double b = (double)stats->batches;
+        double diff;
+        double var;
+
+        if (stats->batches < 2 || stats->hands != base->hands) {
+                return -1;
+        }
+
+        diff = (double)(stats->payoff - base->payoff);
+        var = (stats->batch_diff_sq - diff * diff / b) / (b - 1);
+        est->ev = diff / n / 2.0;
+        est->half_width = t_95(b - 1) * sqrt(var * b) / n / 2.0;
+
+        return SUCCESS;
+} // stats_estimate_diff()
+
+
+
+extern size_t stats_arena_size(int num_accs)
+{
+        return sizeof(struct stats_acc_t) * num_accs;
+} // stats_arena_size()
+
+
+
+extern void stats_acc_end_batch(struct stats_acc_t *acc, int64_t payoff,
+                                int64_t control, int64_t diff)
+{
+        struct stats_t *t = &acc->totals;
+        unsigned long seq = atomic_load_explicit(&acc->seq,
+                                                 memory_order_relaxed);
+
+        atomic_store_explicit(&acc->seq, seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        ++t->batches;
+        t->batch_payoff_sq += (uint64_t)(payoff * payoff);
+        t->batch_control_sq += (uint64_t)(control * control);
+        t->batch_control_payoff += control * payoff;
+        t->batch_diff_sq += (uint64_t)(diff * diff);
+
+        atomic_store_explicit(&acc->seq, seq + 2, memory_order_release);
+} // stats_acc_end_batch()
+
+
+
+extern void stats_acc_read(struct stats_acc_t *acc, struct stats_t *out)
+{
+        unsigned long before;
+        unsigned long after;
+
+        // retry until the copy was not overlapped by an update
+        do {
+                before = atomic_load_explicit(&acc->seq,
+                                              memory_order_acquire);
+                *out = acc->totals;
+                atomic_thread_fence(memory_order_acquire);
+                after = atomic_load_explicit(&acc->seq,
+                                             memory_order_relaxed);
+        } while ((before & 1) || (before != after));
+} // stats_acc_read()
+
+
+
+extern void stats_table_clear(struct stats_table_t *table)
+{
+        memset(table, 0, sizeof(*table));
+} // stats_table_clear()
+
+
+
+extern void stats_table_get(const struct stats_table_t *table, int row,
+                            int up, struct stats_t *out)
+{
+        const struct stats_cell_t *c;
+        int first_row = row < 0 ? 0 : row;
+        int last_row = row < 0 ? STRATEGY_ROWS - 1 : row;
+        int first_up = row < 0 ? 0 : up;
+        int last_up = row < 0 ? STRATEGY_UPCARDS - 1 : up;
+
+        stats_clear(out);
+        for (int r = first_row; r <= last_row; ++r) {
+                for (int u = first_up; u <= last_up; ++u) {
+                        c = &table->cell[r][u];
+                        out->hands += c->hands;
+                        out->wins += c->wins;
+                        out->losses += c->losses;
+                        out->draws += c->draws;
+                        out->payoff += c->payoff;
+                        out->payoff_sq += c->payoff_sq;
+                }
+        }
+} // stats_table_get()
+
+
+// end of stats.c
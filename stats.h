@@ -0,0 +1,194 @@
+// ----------------------------------------------------------------------
+// file: stats.h
+//
+// Description: This is the header file for the STATS module. It counts
+//     the outcomes of simulated hands.
+//
+//     Each simulation worker owns one accumulator, padded to a cache line
+//     so no two workers ever write the same line, and updates it with
+//     plain stores. A sequence counter around every update (a seqlock)
+//     lets a monitoring thread copy a consistent snapshot of any
+//     accumulator at any time without locks and without slowing the
+//     writer. All sums are integers, so merging accumulators gives the
+//     same totals whatever the order.
+//
+//     Besides the plain outcome counts the accumulators keep what the
+//     variance-reduced estimators need: sums for a control variate with
+//     a known mean of zero, and sums over batches (chunks of hands that
+//     are independent of each other) for batch-means confidence
+//     intervals, which stay valid when hands inside a batch are
+//     correlated on purpose (antithetic shoes, common random numbers).
+//
+//     A stats table breaks the outcomes of a batch down by the player's
+//     starting hand and the dealer's up card, for exporting.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "arena.h"
+#include "strategy.h"
+
+// Estimators for stats_estimate().
+#define STATS_PLAIN 0          // sample mean, per-hand variance
+#define STATS_CONTROL 1        // control variate, per-hand variance
+#define STATS_BATCH 2          // sample mean, batch-means variance
+#define STATS_BATCH_CONTROL 3  // control variate at batch level
+
+// Results of a number of hands. Payoffs are in half bets (see
+// session.h), squared payoffs in quarter bets.
+struct stats_t {
+        uint64_t hands;
+        uint64_t wins;
+        uint64_t losses;
+        uint64_t draws;
+        int64_t payoff;
+        uint64_t payoff_sq;
+
+        // control variate (mean zero) of each hand
+        int64_t control;
+        uint64_t control_sq;
+        int64_t control_payoff;
+
+        // sums over batches of the batch totals
+        uint64_t batches;
+        uint64_t batch_payoff_sq;
+        uint64_t batch_control_sq;
+        int64_t batch_control_payoff;
+        uint64_t batch_diff_sq;    // squared difference from strategy #1
+};
+
+// An estimate of the EV per hand (in bets) with the half width of its
+// 95% confidence interval.
+struct estimate_t {
+        double ev;
+        double half_width;
+};
+
+// One worker's accumulator, alone on its cache line(s).
+struct stats_acc_t {
+        _Alignas(ARENA_ALIGN) atomic_ulong seq; // odd while updating
+        struct stats_t totals;
+};
+
+// Outcomes by starting hand (a strategy row) and up card (a strategy
+// column).
+struct stats_cell_t {
+        uint64_t hands;
+        uint64_t wins;
+        uint64_t losses;
+        uint64_t draws;
+        int64_t payoff;
+        uint64_t payoff_sq;
+};
+
+struct stats_table_t {
+        struct stats_cell_t cell[STRATEGY_ROWS][STRATEGY_UPCARDS];
+};
+
+
+// Clear a set of results.
+extern void stats_clear(struct stats_t *stats);
+
+
+// Add the results in 'src' to 'dst'.
+extern void stats_merge(struct stats_t *dst, const struct stats_t *src);
+
+
+// Expected value per hand, in bets.
+extern double stats_ev(const struct stats_t *stats);
+
+
+// Variance of the payoff of one hand, in bets squared.
+extern double stats_variance(const struct stats_t *stats);
+
+
+// Estimate the EV per hand with one of the STATS_ estimators. Returns
+// SUCCESS, or -1 if there are too few hands or batches for it (2, or 3
+// with the control variate). The batch estimators take their 95%
+// interval from Student's t, as a few dozen batches are common.
+extern int stats_estimate(const struct stats_t *stats, int method,
+                          struct estimate_t *est);
+
+
+// Estimate the difference in EV per hand between 'stats' and 'base',
+// two strategies played from the same shoes in the same batches.
+// Returns SUCCESS or -1 if there are too few batches.
+extern int stats_estimate_diff(const struct stats_t *stats,
+                               const struct stats_t *base,
+                               struct estimate_t *est);
+
+
+// Number of arena bytes needed for 'num_accs' accumulators (cleared by
+// arena_alloc()).
+extern size_t stats_arena_size(int num_accs);
+
+
+// Copy a consistent snapshot of one accumulator. Safe to call from any
+// thread while the owner keeps updating it.
+extern void stats_acc_read(struct stats_acc_t *acc, struct stats_t *out);
+
+
+// Record the payoff and control value of one hand. Only the owner of
+// the accumulator may call this; it is inline because it runs once per
+// simulated hand.
+static inline void stats_acc_add(struct stats_acc_t *acc, int payoff,
+                                 int control)
+{
+        struct stats_t *t = &acc->totals;
+        unsigned long seq = atomic_load_explicit(&acc->seq,
+                                                 memory_order_relaxed);
+
+        atomic_store_explicit(&acc->seq, seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        ++t->hands;
+        t->wins += (payoff > 0);
+        t->losses += (payoff < 0);
+        t->draws += (payoff == 0);
+        t->payoff += payoff;
+        t->payoff_sq += (uint64_t)(payoff * payoff);
+        t->control += control;
+        t->control_sq += (uint64_t)(control * control);
+        t->control_payoff += control * payoff;
+
+        atomic_store_explicit(&acc->seq, seq + 2, memory_order_release);
+} // stats_acc_add()
+
+
+// Empty a table.
+extern void stats_table_clear(struct stats_table_t *table);
+
+
+// Copy the outcomes of one cell (or of the whole table if 'row' is
+// negative) into 'out' so the stats_ functions can be used on them.
+extern void stats_table_get(const struct stats_table_t *table, int row,
+                            int up, struct stats_t *out);
+
+
+// Record the payoff of one hand in a table.
+static inline void stats_table_add(struct stats_table_t *table, int row,
+                                   int up, int payoff)
+{
+        struct stats_cell_t *c = &table->cell[row][up];
+
+        ++c->hands;
+        c->wins += (payoff > 0);
+        c->losses += (payoff < 0);
+        c->draws += (payoff == 0);
+        c->payoff += payoff;
+        c->payoff_sq += (uint64_t)(payoff * payoff);
+} // stats_table_add()
+
+
+// Record the totals of a finished batch: its payoff, its control value
+// and its payoff minus that of strategy #1 in the same batch.
+extern void stats_acc_end_batch(struct stats_acc_t *acc, int64_t payoff,
+                                int64_t control, int64_t diff);
+
+#endif
+// end of stats.h
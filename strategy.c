@@ -0,0 +1,219 @@
+// ----------------------------------------------------------------------
+// file: strategy.c
+//
+// Description: This file implements the STRATEGY module.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "common.h"
+#include "card.h"
+#include "strategy.h"
+
+#define LINE_MAX_LEN 128
+
+static const char Upcard_names[STRATEGY_UPCARDS] = {
+        'A', '2', '3', '4', '5', '6', '7', '8', '9', 'T'
+};
+
+
+
+// Return the best total of a row and whether it is soft.
+static int row_total(int row, int *soft)
+{
+        int total;
+
+        if (row < STRATEGY_HARD_ROWS) {
+                *soft = FALSE;
+                total = STRATEGY_HARD_MIN + row;
+        } else {
+                *soft = TRUE;
+                total = STRATEGY_SOFT_MIN + row - STRATEGY_HARD_ROWS;
+        }
+
+        return total;
+} // row_total()
+
+
+
+extern void strategy_default(struct strategy_t *strategy)
+{
+        int soft;
+        int total;
+
+        for (int row = 0; row < STRATEGY_ROWS; ++row) {
+                total = row_total(row, &soft);
+                for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                        strategy->action[row][up] = (total <= DRAW_SCORE) ?
+                                STRATEGY_HIT : STRATEGY_STAND;
+                }
+        }
+} // strategy_default()
+
+
+
+extern int strategy_row(struct score_t score)
+{
+        int low = score.tot_other + score.num_aces;
+        int best = score_best(score);
+        int row;
+
+        if (best != low) {
+                row = STRATEGY_HARD_ROWS + best - STRATEGY_SOFT_MIN;
+        } else if (low < STRATEGY_HARD_MIN) {
+                row = 0;
+        } else if (low > BEST_SCORE) {
+                row = STRATEGY_HARD_ROWS - 1;
+        } else {
+                row = low - STRATEGY_HARD_MIN;
+        }
+
+        return row;
+} // strategy_row()
+
+
+
+extern int strategy_upcard(unsigned char pattern)
+{
+        int up;
+
+        if (pattern >= 10) {
+                up = STRATEGY_UPCARDS - 1;
+        } else {
+                // ace is column 0, 2..9 are columns 1..8
+                up = pattern - ACE;
+        }
+
+        return up;
+} // strategy_upcard()
+
+
+
+extern int strategy_load(struct strategy_t *strategy, const char *path)
+{
+        FILE *in;
+        char line[LINE_MAX_LEN];
+        char kind;
+        int total;
+        int row;
+        int used;
+        int result = SUCCESS;
+        char *p;
+
+        strategy_default(strategy);
+        in = fopen(path, "r");
+        if (in == NULL) {
+                return -1;
+        }
+
+        while (result == SUCCESS && fgets(line, sizeof(line), in) != NULL) {
+                if (line[0] == '#' || line[0] == '\n') {
+                        continue;
+                }
+                if (sscanf(line, " %c%d%n", &kind, &total, &used) != 2) {
+                        result = -1;
+                        break;
+                }
+                if (kind == 'H' && total >= STRATEGY_HARD_MIN &&
+                    total < STRATEGY_HARD_MIN + STRATEGY_HARD_ROWS) {
+                        row = total - STRATEGY_HARD_MIN;
+                } else if (kind == 'S' && total >= STRATEGY_SOFT_MIN &&
+                           total < STRATEGY_SOFT_MIN + STRATEGY_SOFT_ROWS) {
+                        row = STRATEGY_HARD_ROWS + total - STRATEGY_SOFT_MIN;
+                } else {
+                        result = -1;
+                        break;
+                }
+
+                // one decision per up card
+                p = line + used;
+                for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                        while (*p == ' ' || *p == '\t') {
+                                ++p;
+                        }
+                        if (*p == 'H') {
+                                strategy->action[row][up] = STRATEGY_HIT;
+                        } else if (*p == 'S') {
+                                strategy->action[row][up] = STRATEGY_STAND;
+                        } else {
+                                result = -1;
+                                break;
+                        }
+                        ++p;
+                }
+        }
+
+        if (ferror(in)) {
+                result = -1;
+        } else if (result != SUCCESS) {
+                errno = EINVAL;
+        }
+        fclose(in);
+
+        return result;
+} // strategy_load()
+
+
+
+extern void strategy_row_name(int row, char *name)
+{
+        int soft;
+        int total = row_total(row, &soft);
+
+        snprintf(name, STRATEGY_NAME_SIZE, "%c%d", soft ? 'S' : 'H', total);
+} // strategy_row_name()
+
+
+
+extern char strategy_upcard_name(int up)
+{
+        return Upcard_names[up];
+} // strategy_upcard_name()
+
+
+
+extern int strategy_save(const struct strategy_t *strategy,
+                         const char *path)
+{
+        FILE *out;
+        int soft;
+        int total;
+        int result = SUCCESS;
+
+        out = fopen(path, "w");
+        if (out == NULL) {
+                return -1;
+        }
+
+        fprintf(out, "# blackjack strategy: H = hit, S = stand\n");
+        fprintf(out, "#   ");
+        for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                fprintf(out, " %c", Upcard_names[up]);
+        }
+        fprintf(out, "\n");
+        for (int row = 0; row < STRATEGY_ROWS; ++row) {
+                total = row_total(row, &soft);
+                fprintf(out, "%c%-3d", soft ? 'S' : 'H', total);
+                for (int up = 0; up < STRATEGY_UPCARDS; ++up) {
+                        fprintf(out, " %c",
+                                strategy->action[row][up] == STRATEGY_HIT ?
+                                'H' : 'S');
+                }
+                fprintf(out, "\n");
+        }
+
+        if (ferror(out)) {
+                result = -1;
+        }
+        if (fclose(out) != 0) {
+                result = -1;
+        }
+
+        return result;
+} // strategy_save()
+
+
+// end of strategy.c
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------
+// file: strategy.h
+//
+// Description: This is the header file for the STRATEGY module. A
+//     strategy is a table of hit/stand decisions indexed by the player's
+//     hand and the dealer's up card. Hands are rows: hard totals 4..21
+//     and soft totals (an ace counted as 11) 12..21. Up cards are
+//     columns: ace, 2..9 and ten (any ten-valued card).
+//
+//     Strategies are saved as text, one row per line:
+//         H16  H H H S S S H H H H
+//     where the first field names the hand (H = hard, S = soft) and the
+//     rest are the decisions (H = hit, S = stand) for A, 2..9, T.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "score.h"
+
+#define STRATEGY_HARD_MIN 4
+#define STRATEGY_HARD_ROWS 18       // hard 4..21
+#define STRATEGY_SOFT_MIN 12
+#define STRATEGY_SOFT_ROWS 10       // soft 12..21
+#define STRATEGY_ROWS (STRATEGY_HARD_ROWS + STRATEGY_SOFT_ROWS)
+#define STRATEGY_UPCARDS 10
+
+#define STRATEGY_NAME_SIZE 16       // room for a row name ("H21")
+
+#define STRATEGY_STAND 0
+#define STRATEGY_HIT 1
+
+struct strategy_t {
+        unsigned char action[STRATEGY_ROWS][STRATEGY_UPCARDS];
+};
+
+
+// Fill in the strategy of the interactive game's dealer: hit on
+// DRAW_SCORE or less, whatever the up card.
+extern void strategy_default(struct strategy_t *strategy);
+
+
+// Return the row of a hand.
+extern int strategy_row(struct score_t score);
+
+
+// Return the column of a dealer up card, given its pattern.
+extern int strategy_upcard(unsigned char pattern);
+
+
+// Write the name of a row ("H16", "S18") into 'name', which has room
+// for STRATEGY_NAME_SIZE characters.
+extern void strategy_row_name(int row, char *name);
+
+
+// Return the name of an up card column ('A', '2'..'9' or 'T').
+extern char strategy_upcard_name(int up);
+
+
+// Read a strategy from a text file. Rows missing from the file keep the
+// default decisions. Returns SUCCESS or -1 (with errno set for I/O
+// errors).
+extern int strategy_load(struct strategy_t *strategy, const char *path);
+
+
+// Write a strategy to a text file. Returns SUCCESS or -1.
+extern int strategy_save(const struct strategy_t *strategy,
+                         const char *path);
+
+#endif
+// end of strategy.h
@@ -17,14 +17,28 @@
 // 2017-10-30 (P. Clark)
 //     Changed table_exit so it only clears screen if module was properly
 //     initialized.
+// 2026-10-18
+//     Drew each update into a frame buffer that is written out once and
+//     can be fanned out to spectators (table_set_broadcast()).
+//     Precomputed the text of every card and the cursor moves to the
+//     card slots, so drawing a card copies two strings into the frame.
+//     Added the scripted mode (table_init_script()).
+//     Added table_hint().
+//     Added table_set_idle() to run background work while waiting for
+//     a key.
+//     Added table_side_bets().
 // ---------------------------------------------------------------------
 #include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include "common.h"
 #include "card.h"
+#include "broadcast.h"
 #include "table.h"
 
 
@@ -58,6 +72,16 @@
 #define STATS_WIDTH 4
 #define LINEFEED 10
 #define HIDDEN_OFFSET 3
+#define HINT_ROW 13
+#define HINT_WIDTH 50
+#define SIDE_ROW 22
+#define SIDE_COL 1
+#define SIDE_WIDTH 79
+#define FRAME_SIZE 4096
+#define NUM_SUITS 4
+#define TEXT_SIZE 48
+#define SLOT_ROWS TABLE_MIN_ROWS
+#define SCRIPT_BUFFER_SIZE (1 << 16)
 
 // Shapes for displaying cards (in unicode)
 #define SPADE       "\u2660" /* black spade */
@@ -69,6 +93,7 @@
 static unsigned int Table_state = 0;
 static unsigned int Table_wins;
 static unsigned int Table_losses;
+static unsigned int Table_draws;
 static unsigned int Table_rows;
 static unsigned int Table_cols;
 static unsigned char Num_cards_dealer;
@@ -76,31 +101,189 @@ static unsigned char Next_card_player;
 static unsigned char Second_suit;
 static unsigned char Second_pattern;
 static unsigned char Hidden_shown;
+static char Frame[FRAME_SIZE];          // drawn since the last flush
+static size_t Frame_len;
+static int Frame_key;                   // the frame redraws the screen
+static struct broadcast_t *Broadcast;   // spectators, if any
+static int (*Idle)(void *arg);          // background work, if any
+static void *Idle_arg;
+static int Script_fd = -1;              // scripted input; -1 if none
+static char Script[SCRIPT_BUFFER_SIZE]; // ...read ahead
+static size_t Script_len;
+static size_t Script_pos;
+
+// A precomputed piece of output
+struct text_t {
+        unsigned char len;
+        char text[TEXT_SIZE];
+};
+
+// What show_card() writes after moving the cursor (color, rank, suit
+// glyph, and back to hidden at the top left), by suit and pattern; 0
+// stands for anything out of range. And the cursor moves to the card
+// slots of the dealer's and the player's columns, by row.
+static struct text_t Card_text[NUM_SUITS + 1][KING + 1];
+static struct text_t Slot_text[SLOT_ROWS + 1][2];
+static int Texts_built = FALSE;
 
 
 // ************************************************************************
 // ***************** I N T E R N A L   F U N C T I O N S ******************
 // ************************************************************************
 
+// Write out the frame drawn so far, to the terminal and to any
+// spectators.
+static void flush(void)
+{
+        if (Script_fd >= 0) {
+                // nothing is drawn in scripted mode
+                Frame_len = 0;
+                return;
+        }
+        fwrite(Frame, 1, Frame_len, stdout);
+        fflush(stdout);
+        if (Broadcast != NULL && Frame_len > 0) {
+                broadcast_frame(Broadcast, Frame, Frame_len, Frame_key);
+        }
+        Frame_len = 0;
+        Frame_key = FALSE;
+} // flush()
+
+
+
+// Add to the frame, like printf(). A full frame is flushed first.
+static void out(const char *format, ...)
+{
+        va_list args;
+        int len;
+
+        if (Script_fd >= 0) {
+                return;
+        }
+        va_start(args, format);
+        len = vsnprintf(Frame + Frame_len, FRAME_SIZE - Frame_len, format,
+                        args);
+        va_end(args);
+        if (len >= 0 && (size_t)len >= FRAME_SIZE - Frame_len) {
+                flush();
+                va_start(args, format);
+                len = vsnprintf(Frame, FRAME_SIZE, format, args);
+                va_end(args);
+        }
+        if (len > 0) {
+                Frame_len += len;
+                if (Frame_len >= FRAME_SIZE) {
+                        Frame_len = FRAME_SIZE - 1;
+                }
+        }
+} // out()
+
+
+
+// Add a precomputed piece to the frame.
+static void put(const struct text_t *text)
+{
+        if (Script_fd >= 0) {
+                return;
+        }
+        if (Frame_len + text->len > FRAME_SIZE - 1) {
+                flush();
+        }
+        memcpy(Frame + Frame_len, text->text, text->len);
+        Frame_len += text->len;
+} // put()
+
+
+
+// Fill in a text_t like sprintf().
+static void build_text(struct text_t *text, const char *format, ...)
+{
+        va_list args;
+        int len;
+
+        va_start(args, format);
+        len = vsnprintf(text->text, TEXT_SIZE, format, args);
+        va_end(args);
+        text->len = len < TEXT_SIZE ? len : TEXT_SIZE - 1;
+} // build_text()
+
+
+
+// Precompute Card_text and Slot_text.
+static void build_texts(void)
+{
+        static const char *colors[NUM_SUITS + 1] = {
+                BLUE, BLACK, RED, BLACK, RED
+        };
+        static const char *glyphs[NUM_SUITS + 1] = {
+                "X", CLUB, HEART, SPADE, DIAMOND
+        };
+        static const char *ranks[KING + 1] = {
+                "X ", "A ", "2 ", "3 ", "4 ", "5 ", "6 ", "7 ", "8 ",
+                "9 ", "10 ", "J ", "Q ", "K "
+        };
+
+        for (int suit = 0; suit <= NUM_SUITS; ++suit) {
+                for (int m = 0; m <= KING; ++m) {
+                        build_text(&Card_text[suit][m], "%s%s%s%s%s",
+                                   colors[suit], ranks[m], glyphs[suit],
+                                   HIDDEN, MOVE_TOP_LEFT);
+                }
+        }
+        for (int row = 0; row <= SLOT_ROWS; ++row) {
+                build_text(&Slot_text[row][0], MOVE_CURSOR, row,
+                           DEALER_COL);
+                build_text(&Slot_text[row][1], MOVE_CURSOR, row,
+                           PLAYER_COL);
+        }
+        Texts_built = TRUE;
+} // build_texts()
+
+
+
+// Return the next key of the script, skipping line feeds, or 'q' at
+// its end.
+static int script_input(void)
+{
+        char input;
+        ssize_t count;
+
+        do {
+                if (Script_pos == Script_len) {
+                        count = read(Script_fd, Script, SCRIPT_BUFFER_SIZE);
+                        if (count <= 0) {
+                                return 'q';
+                        }
+                        Script_len = count;
+                        Script_pos = 0;
+                }
+                input = Script[Script_pos++];
+        } while (input == LINEFEED);
+
+        return input;
+} // script_input()
+
+
+
 static void move_cursor(int col, int row) {
-        printf(MOVE_CURSOR, row, col);
+        out(MOVE_CURSOR, row, col);
 }
 
 
 
 static void draw_menu(void)
 {
-        printf(MOVE_TOP_LEFT);
-        printf("\n\n");
-        printf(BLUE);
-        printf(" Menu\n");
-        printf("------\n");
-        printf(RED);    printf("H");
-        printf(NORMAL); printf("=Hit\n");
-        printf(RED);    printf("S");
-        printf(NORMAL); printf("=Stand\n");
-        printf(RED);    printf("Q");
-        printf(NORMAL); printf("=Quit\n");
+        out(MOVE_TOP_LEFT);
+        out("\n\n");
+        out(BLUE);
+        out(" Menu\n");
+        out("------\n");
+        out(RED);    out("H");
+        out(NORMAL); out("=Hit\n");
+        out(RED);    out("S");
+        out(NORMAL); out("=Stand\n");
+        out(RED);    out("Q");
+        out(NORMAL); out("=Quit\n");
 } // draw_menu()
 
 
@@ -108,15 +291,15 @@ static void draw_menu(void)
 static void draw_stats(void)
 {
         // Score
-        printf(BLUE);
+        out(BLUE);
         move_cursor(WINS_COL, WINS_ROW);
-        printf("Wins:   %*d", STATS_WIDTH, Table_wins);
+        out("Wins:   %*d", STATS_WIDTH, Table_wins);
         move_cursor(LOSS_COL, LOSS_ROW);
-        printf("Losses: %*d", STATS_WIDTH, Table_losses);
-        printf("\n\n");
-        printf(HIDDEN);
-        printf(MOVE_TOP_LEFT);
-        fflush(stdout);
+        out("Losses: %*d", STATS_WIDTH, Table_losses);
+        out("\n\n");
+        out(HIDDEN);
+        out(MOVE_TOP_LEFT);
+        flush();
 } // draw_stats()
 
 
@@ -127,101 +310,56 @@ static void show_card(
         const unsigned char row,
         const unsigned char col)
 {
-        // Move to the correct location and set the color
-        // that is appropriate to the suit.
-        move_cursor(col, row);
-        switch (suit) {
-                case HEARTS:
-                case DIAMONDS:
-                        printf(RED);
-                        break;
-                case SPADES:
-                case CLUBS:
-                        printf(BLACK);
-                        break;
-                default:
-                        printf(BLUE);
-                        break;
-        }
+        int s = suit <= NUM_SUITS ? suit : 0;
+        int m = pattern <= KING ? pattern : 0;
 
-
-        // Display the card 
-        if (pattern > ACE && pattern < JACK) {
-                printf("%d ", pattern);
+        // Move to the correct location, then draw the card in the color
+        // that is appropriate to the suit.
+        if (row <= SLOT_ROWS && col == DEALER_COL) {
+                put(&Slot_text[row][0]);
+        } else if (row <= SLOT_ROWS && col == PLAYER_COL) {
+                put(&Slot_text[row][1]);
         } else {
-                switch (pattern) {
-                        case JACK:
-                                printf("J");
-                                break;
-                        case QUEEN:
-                                printf("Q");
-                                break;
-                        case KING:
-                                printf("K");
-                                break;
-                        case ACE:
-                                printf("A");
-                                break;
-                        default:
-                                printf("X");
-                                break;
-                }
-                printf(" ");
+                move_cursor(col, row);
         }
-        switch (suit) {
-                case CLUBS: 
-                        printf(CLUB);
-                        break;
-                case HEARTS:
-                        printf(HEART);
-                        break;
-                case SPADES:
-                        printf(SPADE);
-                        break;
-                case DIAMONDS: 
-                        printf(DIAMOND);
-                        break;
-                default:
-                        printf("X");
-                        break;
-        }
-        printf(HIDDEN);
-        printf(MOVE_TOP_LEFT);
-        fflush(stdout);
+        put(&Card_text[s][m]);
+        flush();
 } // show_card()
 
 
 
 static void draw_table(void) 
 {
-        // give us a green table
-        printf(NORMAL);
-        printf(CLEAR_SCREEN);
+        // give us a green table; spectators can join here
+        flush();
+        Frame_key = TRUE;
+        out(NORMAL);
+        out(CLEAR_SCREEN);
 
         // Title
-        printf(MOVE_TOP_LEFT);
-        printf(RED);
-        printf("                                B L A C K J A C K\n");
+        out(MOVE_TOP_LEFT);
+        out(RED);
+        out("                                B L A C K J A C K\n");
 
         // menu
         draw_menu();
 
         // Headings
-        printf(BLUE);
+        out(BLUE);
         move_cursor(DEALER_COL, DEALER_ROW);
-        printf("Dealer");
+        out("Dealer");
         move_cursor(DEALER_COL, DEALER_ROW+1);
-        printf("------");
+        out("------");
         move_cursor(PLAYER_COL, PLAYER_ROW);
-        printf("You");
+        out("You");
         move_cursor(PLAYER_COL, PLAYER_ROW+1);
-        printf("---");
+        out("---");
 
         // wins, losses
         draw_stats();
 
-        printf(MOVE_TOP_LEFT);
-        fflush(stdout);
+        out(MOVE_TOP_LEFT);
+        flush();
 } // draw_table()
 
 
@@ -245,9 +383,13 @@ extern int table_init(void)
         } 
         
         if (result == SUCCESS) {
+                if (!Texts_built) {
+                        build_texts();
+                }
                 Table_state = TABLE_INITIALIZED;
                 Table_wins = 0;
                 Table_losses = 0;
+                Table_draws = 0;
                 Num_cards_dealer = 0;
                 Next_card_player = STARTING_CARD_ROW;
                 Hidden_shown = 0;
@@ -258,6 +400,24 @@ extern int table_init(void)
 
 
 
+extern int table_init_script(int fd)
+{
+        Script_fd = fd;
+        Script_len = 0;
+        Script_pos = 0;
+        Table_state = TABLE_INITIALIZED;
+        Table_wins = 0;
+        Table_losses = 0;
+        Table_draws = 0;
+        Num_cards_dealer = 0;
+        Next_card_player = STARTING_CARD_ROW;
+        Hidden_shown = 0;
+
+        return SUCCESS;
+} // table_init_script()
+
+
+
 extern int table_reset(void)
 {
         int result = SUCCESS;
@@ -277,17 +437,37 @@ extern int table_reset(void)
 
 
 
+extern void table_set_broadcast(struct broadcast_t *broadcast)
+{
+        Broadcast = broadcast;
+} // table_set_broadcast()
+
+
+
+extern void table_set_idle(int (*idle)(void *arg), void *arg)
+{
+        Idle = idle;
+        Idle_arg = arg;
+} // table_set_idle()
+
+
+
 extern void table_exit(void)
 {
         // Only clear the screen and move cursor if the table was
         // initialized. Without this test, if the terminal is too small,
         // then the error will not be seen by the user.
-        if (Table_state == TABLE_INITIALIZED) {
-                printf(RESET);
-                printf(CLEAR_SCREEN);
-                printf(MOVE_TOP_LEFT);
+        if (Table_state == TABLE_INITIALIZED && Script_fd >= 0) {
+                // report once, however many times the game exits
+                printf("wins %u losses %u draws %u\n", Table_wins,
+                       Table_losses, Table_draws);
+                Table_state = 0;
+        } else if (Table_state == TABLE_INITIALIZED) {
+                out(RESET);
+                out(CLEAR_SCREEN);
+                out(MOVE_TOP_LEFT);
         }
-        fflush(stdout);
+        flush();
 } // table_exit()
 
 
@@ -297,15 +477,24 @@ extern int table_get_input(void)
         char input = 0;
         ssize_t count = 0;
 
-        printf(HIDDEN);
-        printf(MOVE_TOP_LEFT);
-        fflush(stdout);
+        if (Script_fd >= 0) {
+                return script_input();
+        }
+        out(HIDDEN);
+        out(MOVE_TOP_LEFT);
+        flush();
+        if (Idle != NULL) {
+                struct pollfd key = { STDIN_FILENO, POLLIN, 0 };
+                // work in slices until a key is waiting or it is done
+                while (poll(&key, 1, 0) == 0 && Idle(Idle_arg)) {
+                }
+        }
         do {
                 // get one character from the user
                 count = read(STDIN_FILENO, &input, 1);
         } while ((input == LINEFEED) && (count >= 0));
-        printf(MOVE_TOP_LEFT);
-        fflush(stdout);
+        out(MOVE_TOP_LEFT);
+        flush();
 
         return input;
 } // table_get_input()
@@ -313,6 +502,30 @@ extern int table_get_input(void)
 
 
 
+extern void table_hint(int line, const char *text)
+{
+        out(BLUE);
+        move_cursor(MESSAGE_START_COL, HINT_ROW + line);
+        out("%-*.*s", HINT_WIDTH, HINT_WIDTH, text);
+        out(HIDDEN);
+        out(MOVE_TOP_LEFT);
+        flush();
+} // table_hint()
+
+
+
+extern void table_side_bets(const char *text)
+{
+        out(BLACK);
+        move_cursor(SIDE_COL, SIDE_ROW);
+        out("%-*.*s", SIDE_WIDTH, SIDE_WIDTH, text);
+        out(HIDDEN);
+        out(MOVE_TOP_LEFT);
+        flush();
+} // table_side_bets()
+
+
+
 extern void table_player_card(const unsigned char suit,
                               const unsigned char pattern)
 {
@@ -331,8 +544,8 @@ extern void table_dealer_card(const unsigned char suit,
                 Second_suit = suit;
                 Second_pattern = pattern;
                 move_cursor(DEALER_COL, DEALER_ROW+HIDDEN_OFFSET);
-                printf(BLACK);
-                printf("? ?");
+                out(BLACK);
+                out("? ?");
         } else if (Num_cards_dealer == 3) {
                 // We are now dealing third card -- display 2nd card now
                 // before showing the third card.
@@ -363,18 +576,18 @@ extern void table_player_won(void)
         ++Table_wins;
         draw_stats();
 
-        printf(RED);
+        out(RED);
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
+        out("+------------------------+");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|         YOU WON!       |");
+        out("|         YOU WON!       |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|                        |");
+        out("|                        |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|   enter C to continue  |");
+        out("|   enter C to continue  |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
-        fflush(stdout);
+        out("+------------------------+");
+        flush();
 
         // wait until user indicates he/she wants to continue 
         do {
@@ -398,18 +611,21 @@ extern void table_player_draw(void)
                           DEALER_ROW+3, DEALER_COL);
         }
 
-        printf(RED);
+        // update stats
+        ++Table_draws;
+
+        out(RED);
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
+        out("+------------------------+");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|          DRAW          |");
+        out("|          DRAW          |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|                        |");
+        out("|                        |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|   enter C to continue  |");
+        out("|   enter C to continue  |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
-        fflush(stdout);
+        out("+------------------------+");
+        flush();
 
         // wait 
         do {
@@ -436,18 +652,18 @@ extern void table_player_lost(void)
         ++Table_losses;
         draw_stats();
 
-        printf(RED);
+        out(RED);
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
+        out("+------------------------+");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|         YOU LOST       |");
+        out("|         YOU LOST       |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|                        |");
+        out("|                        |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("|   enter C to continue  |");
+        out("|   enter C to continue  |");
         move_cursor(MESSAGE_START_COL, row++);
-        printf("+------------------------+");
-        fflush(stdout);
+        out("+------------------------+");
+        flush();
 
         // wait until user indicates he/she wants to continue 
         do {
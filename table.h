@@ -5,11 +5,25 @@
 //
 // Created: 2016-05-03 (P. Clark)
 //
+// Modifications:
+// 2026-10-18
+//     Added table_set_broadcast().
+//     Added table_init_script().
+//     Added table_hint().
+//     Added table_set_idle().
+//     Added table_side_bets().
 // ---------------------------------------------------------------------
 #ifndef TABLE_H
 #define TABLE_H
 
+struct broadcast_t;
+
 extern int table_init(void);
+
+// Set up the table for a scripted game instead of table_init(): the
+// keys are read from 'fd' in large chunks (the game quits at its end),
+// nothing is drawn, and table_exit() prints the wins, losses and draws.
+extern int table_init_script(int fd);
 extern int table_reset(void);
 extern int table_get_input(void);
 extern void table_player_card(const unsigned char suit,
@@ -17,9 +31,25 @@ extern void table_player_card(const unsigned char suit,
 extern void table_dealer_card(const unsigned char suit,
                               const unsigned char pattern);
 extern void table_player_lost(void);
+
+// Show a line of advice above the messages (replacing the last one on
+// that line); 'line' is 0 or 1.
+extern void table_hint(int line, const char *text);
+
+// Show the results of the side bets under the wins and losses.
+extern void table_side_bets(const char *text);
 extern void table_player_won(void);
 extern void table_player_draw(void);
 extern void table_exit(void);
 
+// Send everything drawn from now on to the spectators of 'broadcast'
+// as well (NULL to stop).
+extern void table_set_broadcast(struct broadcast_t *broadcast);
+
+// While table_get_input() waits for a key, call 'idle' with 'arg' as
+// long as no key is waiting and it returns TRUE (there is more to do).
+// Each call should be short, as a key is not read until it returns.
+extern void table_set_idle(int (*idle)(void *arg), void *arg);
+
 #endif 
 // end of table.h
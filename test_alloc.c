@@ -0,0 +1,144 @@
+// ----------------------------------------------------------------------
+// file: test_alloc.c
+//
+// Description: This program checks that steady-state play does not use
+//     the heap. It is linked with --wrap for malloc, calloc, realloc,
+//     free and the aligned allocators (aligned_alloc, posix_memalign,
+//     memalign) so every heap call made by the game modules is counted,
+//     then creates a few sessions and plays millions of hands with them.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include "common.h"
+#include "arena.h"
+#include "session.h"
+
+#define NUM_SESSIONS 4
+#define NUM_HANDS 5000000
+
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t num, size_t size);
+extern void *__real_realloc(void *ptr, size_t size);
+extern void __real_free(void *ptr);
+extern void *__real_aligned_alloc(size_t alignment, size_t size);
+extern int __real_posix_memalign(void **ptr, size_t alignment, size_t size);
+extern void *__real_memalign(size_t alignment, size_t size);
+
+unsigned long Num_heap_calls = 0;
+
+
+void *__wrap_malloc(size_t size)
+{
+        ++Num_heap_calls;
+        return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+        ++Num_heap_calls;
+        return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+        ++Num_heap_calls;
+        return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+        ++Num_heap_calls;
+        __real_free(ptr);
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size)
+{
+        ++Num_heap_calls;
+        return __real_aligned_alloc(alignment, size);
+}
+
+int __wrap_posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+        ++Num_heap_calls;
+        return __real_posix_memalign(ptr, alignment, size);
+}
+
+void *__wrap_memalign(size_t alignment, size_t size)
+{
+        ++Num_heap_calls;
+        return __real_memalign(alignment, size);
+}
+
+
+
+int main(int argc, const char *argv[])
+{
+        struct arena_t arena;
+        struct session_t *sessions[NUM_SESSIONS];
+        unsigned long heap_calls;
+        unsigned long long hands = 0;
+        int i;
+        int result = 0;
+
+        // creating the arena is allowed to allocate...
+        if (arena_init(&arena, session_arena_size(NUM_SESSIONS)) != SUCCESS) {
+                printf("-Bad: could not create the arena\n");
+                return 1;
+        }
+        if (Num_heap_calls == 0) {
+                // the arena's own allocation has to be seen, or the
+                // wrappers are not counting what the modules call
+                printf("-Bad: the arena was allocated without a counted "
+                       "heap call\n");
+                result = 1;
+        }
+        for (i = 0; i < NUM_SESSIONS; ++i) {
+                sessions[i] = session_create(&arena, i + 1, i);
+                if (sessions[i] == NULL) {
+                        printf("-Bad: could not create session %d\n", i);
+                        return 1;
+                }
+        }
+
+        // ...but once every session is created, playing hands is not
+        heap_calls = Num_heap_calls;
+        for (i = 0; i < NUM_HANDS; ++i) {
+                session_play_hand(sessions[i % NUM_SESSIONS]);
+        }
+        heap_calls = Num_heap_calls - heap_calls;
+
+        for (i = 0; i < NUM_SESSIONS; ++i) {
+                hands += sessions[i]->hands;
+        }
+        if (hands != NUM_HANDS) {
+                printf("-Bad: %llu hands played instead of %d\n",
+                       hands, NUM_HANDS);
+                result = 1;
+        }
+        if (heap_calls != 0) {
+                printf("-Bad: %lu heap calls while playing %d hands\n",
+                       heap_calls, NUM_HANDS);
+                result = 1;
+        } else {
+                printf("-Good: no heap calls while playing %d hands\n",
+                       NUM_HANDS);
+        }
+
+        // a full arena must refuse new sessions instead of growing
+        if (session_create(&arena, 1, 0) != NULL) {
+                printf("-Bad: arena grew beyond its size\n");
+                result = 1;
+        } else {
+                printf("-Good: full arena refused another session\n");
+        }
+
+        arena_free(&arena);
+
+        return result;
+}
+
+// end of test_alloc.c
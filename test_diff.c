@@ -0,0 +1,619 @@
+// ----------------------------------------------------------------------
+// file: test_diff.c
+//
+// Description: This program checks the optimized game engine against
+//     the original rules. It carries reference copies of the scoring
+//     functions as they were written in main.c (best_score, isover and
+//     update_score) and a plain hand loop built on them, and plays them
+//     side by side with every engine variant on copies of the same
+//     seeded shoes:
+//         score       the SCORE module against the reference functions
+//                     for every hand of up to SCORE_CARDS cards
+//         card_get    card_get() deals what a one-deck shoe does
+//         hands       engine and reference give the same payoff and
+//                     leave the shoe in the same state, hand by hand
+//                     and in batches, for each shoe mode, rule set and
+//                     player strategy, exporting results, placing
+//                     side bets and adding up the control variate or not
+//     When a hand differs, its cards are replayed from a stacked shoe
+//     and shrunk (cards removed or lowered one at a time while the
+//     difference remains) to a minimal reproducing case, which is
+//     printed. The harness checks itself by playing the engine against a
+//     reference dealer with the other soft 17 rule, which must be caught.
+//     Usage: test_diff [-n hands]     (hands per configuration)
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "common.h"
+#include "arena.h"
+#include "card.h"
+#include "score.h"
+#include "strategy.h"
+#include "session.h"
+#include "control.h"
+
+#define NUM_HANDS 200000
+#define BATCH_HANDS 1000
+#define SCORE_CARDS 5
+#define CARD_GET_CARDS 10000
+#define SEED 20171103
+#define MAX_HAND_CARDS 32
+
+#define NUM_SHOES 5
+#define NUM_RULES 6
+#define NUM_STRATEGIES 3
+#define NUM_OPTIONS 4           // none, export, side bets, both
+#define OPTION_EXPORT 1
+#define OPTION_SIDEBETS 2
+#define OPTION_CONTROL 4        // on every other rule set
+
+// A game configuration
+struct config_t {
+        int shoe;               // index into Shoe_names
+        struct rules_t rules;   // of the engine
+        struct rules_t ref_rules;   // of the reference
+        int strategy;           // index into Strategy_names
+        int options;            // OPTION_ flags of the engine
+};
+
+// The cards a reference hand dealt, in order
+struct hand_log_t {
+        int num;
+        unsigned char pattern[MAX_HAND_CARDS];
+};
+
+static const char *Shoe_names[NUM_SHOES] = {
+        "1 deck", "6 decks", "8 decks riffled, cut card", "infinite deck",
+        "continuous shuffler"
+};
+static const char *Strategy_names[NUM_STRATEGIES] = {
+        "none", "dealer's", "random"
+};
+
+static struct strategy_t Strategies[NUM_STRATEGIES];
+static struct session_t *Session;
+static struct stats_acc_t Acc;
+static struct stats_table_t Table;      // for OPTION_EXPORT
+static struct control_table_t Control;  // for OPTION_CONTROL
+static int Expecting_diff = FALSE;  // TRUE: a difference is not reported
+static long long Diff_hand;         // the hand that differed (-1: a batch)
+
+
+
+// ---------------- reference implementations (from main.c) ------------
+
+static int best_score(struct score_t score)
+{
+        int tot;
+
+        // First calc the lowest possible score
+        tot = score.tot_other + score.num_aces;
+
+        // Now see if we can improve the score by replacing one of the
+        // aces with an '11'. We can obviously only do that once or we
+        // automatically go over.
+        if (score.num_aces > 0) {
+                if ((tot - LOW_ACE + HIGH_ACE) <= BEST_SCORE) {
+                        tot = tot - LOW_ACE + HIGH_ACE;
+                }
+        }
+
+        return tot;
+} // best_score()
+
+
+
+static unsigned char isover(struct score_t score)
+{
+        unsigned char result;
+
+        if (best_score(score) > BEST_SCORE) {
+                result = TRUE;
+        }  else {
+                result = FALSE;
+        }
+
+        return result;
+} // isover()
+
+
+
+static void update_score(struct score_t *score, unsigned char pattern)
+{
+        if (pattern > ACE && pattern < JACK) {
+                score->tot_other = score->tot_other + pattern;
+        } else if (pattern == ACE) {
+                score->num_aces = score->num_aces + 1;
+        } else {
+                // face card
+                score->tot_other = score->tot_other + 10;
+        }
+} // update_score()
+
+
+
+static unsigned char ref_deal(struct shoe_t *shoe, struct hand_log_t *log)
+{
+        unsigned char pattern = CARD_PATTERN(shoe_deal(shoe));
+
+        if (log->num < MAX_HAND_CARDS) {
+                log->pattern[log->num++] = pattern;
+        }
+        return pattern;
+} // ref_deal()
+
+
+
+// Play a hand the way main.c does, with the rules and the player's
+// decisions of the headless games, and return the payoff in half bets.
+static int ref_play_hand(struct shoe_t *shoe, const struct rules_t *rules,
+                         const struct strategy_t *strategy,
+                         struct hand_log_t *log)
+{
+        struct score_t player = { 0, 0 };
+        struct score_t dealer = { 0, 0 };
+        unsigned char upcard;
+        int soft;
+
+        log->num = 0;
+        shoe_round(shoe);
+
+        // deal two cards each, player first
+        update_score(&player, ref_deal(shoe, log));
+        upcard = ref_deal(shoe, log);
+        update_score(&dealer, upcard);
+        update_score(&player, ref_deal(shoe, log));
+        update_score(&dealer, ref_deal(shoe, log));
+
+        // See if the player wins automatically with 21
+        if (best_score(player) == BEST_SCORE) {
+                if (best_score(dealer) == BEST_SCORE) {
+                        return PAYOFF_DRAW;
+                }
+                return rules->natural_payoff;
+        }
+
+        // what does player want to do?
+        while (!isover(player) &&
+               (strategy == NULL ?
+                best_score(player) <= DRAW_SCORE :
+                strategy->action[strategy_row(player)]
+                                [strategy_upcard(upcard)] == STRATEGY_HIT)) {
+                update_score(&player, ref_deal(shoe, log));
+        }
+        if (isover(player)) {
+                return PAYOFF_LOSS;
+        }
+
+        // dealer's turn; a soft hand counts an ace as 11
+        for (;;) {
+                soft = dealer.num_aces > 0 &&
+                       best_score(dealer) != dealer.tot_other +
+                                             dealer.num_aces;
+                if (best_score(dealer) > DRAW_SCORE + 1 ||
+                    (best_score(dealer) == DRAW_SCORE + 1 &&
+                     !(soft && rules->hit_soft_17))) {
+                        break;
+                }
+                update_score(&dealer, ref_deal(shoe, log));
+        }
+        if (isover(dealer) || best_score(player) > best_score(dealer)) {
+                return PAYOFF_WIN;
+        } else if (best_score(player) == best_score(dealer)) {
+                return PAYOFF_DRAW;
+        }
+        return PAYOFF_LOSS;
+} // ref_play_hand()
+
+// ---------------------------------------------------------------------
+
+
+
+// Set up the session's shoe for a configuration.
+static void init_shoe(struct shoe_t *shoe, int kind, uint64_t seed)
+{
+        switch (kind) {
+        case 0:
+                shoe_init(shoe, 1, seed);
+                break;
+        case 1:
+                shoe_init(shoe, 6, seed);
+                break;
+        case 2:
+                shoe_init(shoe, MAX_DECKS, seed);
+                shoe_set_shuffle(shoe, "rrsrbc", MAX_SHOE_CARDS * 3 / 4);
+                break;
+        case 3:
+                shoe_init_infinite(shoe, seed);
+                break;
+        default:
+                shoe_init_csm(shoe, 4, 20, seed);
+                break;
+        }
+} // init_shoe()
+
+
+
+// Return TRUE if two shoes will deal the same from now on.
+static int same_shoe(const struct shoe_t *a, const struct shoe_t *b)
+{
+        return memcmp(&a->rng, &b->rng, sizeof(a->rng)) == 0 &&
+               a->next == b->next &&
+               memcmp(a->left, b->left, sizeof(a->left)) == 0 &&
+               memcmp(a->cards, b->cards, a->num_cards) == 0 &&
+               (a->mode != SHOE_CSM ||
+                memcmp(&a->csm, &b->csm, sizeof(a->csm)) == 0);
+} // same_shoe()
+
+
+
+static void print_cards(const unsigned char *pattern, int num)
+{
+        static const char *names = "?A23456789TJQK";
+
+        for (int i = 0; i < num; ++i) {
+                printf(" %c", names[pattern[i]]);
+        }
+} // print_cards()
+
+
+
+static void print_config(const struct config_t *config)
+{
+        printf("%s, natural pays %d/2, dealer %s soft 17, strategy %s%s%s%s",
+               Shoe_names[config->shoe], config->rules.natural_payoff,
+               config->rules.hit_soft_17 ? "hits" : "stands on",
+               Strategy_names[config->strategy],
+               (config->options & OPTION_EXPORT) ? ", exporting" : "",
+               (config->options & OPTION_SIDEBETS) ? ", side bets" : "",
+               (config->options & OPTION_CONTROL) ? ", control" : "");
+} // print_config()
+
+
+
+// Play one hand with the engine and with the reference from the
+// session's shoe. Returns TRUE if they differ.
+static int differs(const struct config_t *config, struct hand_log_t *log,
+                   int *payoff, int *ref_payoff)
+{
+        const struct strategy_t *strategy = NULL;
+        struct shoe_t shoe = Session->shoe;
+
+        if (config->strategy > 0) {
+                strategy = &Strategies[config->strategy];
+        }
+        *payoff = session_play_hand(Session);
+        *ref_payoff = ref_play_hand(&shoe, &config->ref_rules, strategy,
+                                    log);
+
+        return *payoff != *ref_payoff || !same_shoe(&Session->shoe, &shoe);
+} // differs()
+
+
+
+// Fill a stacked shoe that deals the 'num' patterns first.
+static void stack_shoe(struct shoe_t *shoe, const unsigned char *pattern,
+                       int num)
+{
+        shoe_init(shoe, MAX_DECKS, SEED);
+        for (int i = 0; i < num; ++i) {
+                for (int j = i; j < shoe->num_cards; ++j) {
+                        if (CARD_PATTERN(shoe->cards[j]) == pattern[i]) {
+                                unsigned char code = shoe->cards[j];
+                                shoe->cards[j] = shoe->cards[i];
+                                shoe->cards[i] = code;
+                                break;
+                        }
+                }
+        }
+} // stack_shoe()
+
+
+
+// Return TRUE if a hand dealt from a shoe stacked with the patterns
+// differs.
+static int stacked_differs(const struct config_t *config,
+                           const unsigned char *pattern, int num,
+                           struct hand_log_t *log)
+{
+        int payoff;
+        int ref_payoff;
+
+        stack_shoe(&Session->shoe, pattern, num);
+        return differs(config, log, &payoff, &ref_payoff);
+} // stacked_differs()
+
+
+
+// Shrink the cards of a differing hand to a minimal case and print it.
+static void report_minimal(const struct config_t *config,
+                           const struct hand_log_t *found)
+{
+        struct hand_log_t log;
+        unsigned char cards[MAX_HAND_CARDS];
+        unsigned char trial[MAX_HAND_CARDS];
+        int num = found->num;
+        int payoff;
+        int ref_payoff;
+        int shrunk = TRUE;
+
+        memcpy(cards, found->pattern, num);
+        if (!stacked_differs(config, cards, num, &log)) {
+                printf("    the difference depends on the shoe's state;"
+                       " cards dealt:");
+                print_cards(cards, num);
+                printf("\n");
+                return;
+        }
+
+        while (shrunk) {
+                shrunk = FALSE;
+
+                // drop a card
+                for (int i = num - 1; i >= 0; --i) {
+                        memcpy(trial, cards, i);
+                        memcpy(trial + i, cards + i + 1, num - i - 1);
+                        if (stacked_differs(config, trial, num - 1, &log)) {
+                                memcpy(cards, trial, --num);
+                                shrunk = TRUE;
+                        }
+                }
+
+                // lower a card
+                for (int i = 0; i < num; ++i) {
+                        for (int m = ACE; m < cards[i]; ++m) {
+                                memcpy(trial, cards, num);
+                                trial[i] = m;
+                                if (stacked_differs(config, trial, num,
+                                                    &log)) {
+                                        cards[i] = m;
+                                        shrunk = TRUE;
+                                        break;
+                                }
+                        }
+                }
+        }
+
+        // only the cards the reference hand dealt matter
+        stack_shoe(&Session->shoe, cards, num);
+        differs(config, &log, &payoff, &ref_payoff);
+        printf("    minimal case (player, up card, player, hole card, "
+               "draws):");
+        print_cards(log.pattern, log.num);
+        printf("\n    engine pays %d, reference pays %d\n", payoff,
+               ref_payoff);
+} // report_minimal()
+
+
+
+// Play 'num_hands' hands and a batch in a configuration. Returns TRUE if
+// the engine and the reference agreed.
+static int run_config(const struct config_t *config, uint64_t seed,
+                      unsigned long long num_hands)
+{
+        const struct strategy_t *strategy = NULL;
+        struct hand_log_t log;
+        struct shoe_t shoe;
+        int payoff;
+        int ref_payoff;
+        int64_t batch_payoff = 0;
+        int64_t ref_batch_payoff = 0;
+        int64_t control = 0;
+
+        if (config->strategy > 0) {
+                strategy = &Strategies[config->strategy];
+        }
+        init_shoe(&Session->shoe, config->shoe, seed);
+        session_set_rules(Session, &config->rules);
+        session_set_strategy(Session, strategy);
+        session_set_table(Session, (config->options & OPTION_EXPORT) ?
+                                   &Table : NULL);
+        session_set_sidebets(Session, (config->options & OPTION_SIDEBETS) ?
+                                      SIDEBET_ALL : 0);
+        if (config->options & OPTION_CONTROL) {
+                control_compute(&Control, &config->rules, strategy,
+                                Session->shoe.full);
+                session_set_control(Session, &Control);
+        } else {
+                session_set_control(Session, NULL);
+        }
+
+        for (unsigned long long i = 0; i < num_hands; ++i) {
+                if (differs(config, &log, &payoff, &ref_payoff)) {
+                        Diff_hand = i;
+                        if (Expecting_diff) {
+                                return FALSE;
+                        }
+                        printf("-Bad: hand %llu differs: ", i);
+                        print_config(config);
+                        printf("\n    engine %s pays %d, reference pays "
+                               "%d%s\n", Session->engine->name, payoff,
+                               ref_payoff, payoff == ref_payoff ?
+                               ", but the shoes differ" : "");
+                        report_minimal(config, &log);
+                        return FALSE;
+                }
+        }
+
+        // a batch must end where as many single hands end
+        shoe = Session->shoe;
+        Session->engine->play_run(Session, BATCH_HANDS, &Acc,
+                                  &batch_payoff, &control);
+        for (int i = 0; i < BATCH_HANDS; ++i) {
+                ref_batch_payoff += ref_play_hand(&shoe, &config->ref_rules,
+                                                  strategy, &log);
+        }
+        if (batch_payoff != ref_batch_payoff ||
+            !same_shoe(&Session->shoe, &shoe)) {
+                Diff_hand = -1;
+                if (Expecting_diff) {
+                        return FALSE;
+                }
+                printf("-Bad: a batch differs: ");
+                print_config(config);
+                printf("\n    engine %s pays %lld, reference pays %lld\n",
+                       Session->engine->name, (long long)batch_payoff,
+                       (long long)ref_batch_payoff);
+                return FALSE;
+        }
+
+        return TRUE;
+} // run_config()
+
+
+
+// Compare the SCORE module with the reference on every hand of up to
+// SCORE_CARDS cards. Returns the number of differences.
+static int check_scores(struct score_t mine, struct score_t ref, int depth)
+{
+        int bad = 0;
+
+        if (score_best(mine) != best_score(ref) ||
+            score_isover(mine) != isover(ref) ||
+            mine.num_aces != ref.num_aces ||
+            mine.tot_other != ref.tot_other) {
+                return 1;
+        }
+        if (depth == SCORE_CARDS) {
+                return 0;
+        }
+        for (int m = ACE; m <= KING; ++m) {
+                struct score_t a = mine;
+                struct score_t b = ref;
+                score_update(&a, m);
+                update_score(&b, m);
+                bad += check_scores(a, b, depth + 1);
+        }
+
+        return bad;
+} // check_scores()
+
+
+
+int main(int argc, char *argv[])
+{
+        static const int payoffs[NUM_RULES / 2] = { PAYOFF_WIN, 3, 4 };
+        struct arena_t arena;
+        struct config_t config;
+        struct score_t empty = { 0, 0 };
+        struct shoe_t shoe;
+        struct rng_t rng;
+        unsigned long long num_hands = NUM_HANDS;
+        unsigned char suit;
+        unsigned char pattern;
+        int num_configs = 0;
+        int num_failed = 0;
+        int bad;
+        int opt;
+
+        while ((opt = getopt(argc, argv, "n:")) != -1) {
+                if (opt == 'n') {
+                        num_hands = strtoull(optarg, NULL, 10);
+                } else {
+                        fprintf(stderr, "usage: %s [-n hands]\n", argv[0]);
+                        return 1;
+                }
+        }
+
+        // the scoring functions
+        bad = check_scores(empty, empty, 0);
+        if (bad > 0) {
+                printf("-Bad: the score module differs on %d hands\n", bad);
+                ++num_failed;
+        } else {
+                printf("-Good: the score module matches on every hand of "
+                       "up to %d cards\n", SCORE_CARDS);
+        }
+
+        // the dealing path: card_get() without card_init() uses seed 0
+        shoe_init(&shoe, 1, 0);
+        bad = 0;
+        for (int i = 0; i < CARD_GET_CARDS; ++i) {
+                unsigned char code = shoe_deal(&shoe);
+                card_get(&suit, &pattern);
+                bad += suit != CARD_SUIT(code) ||
+                       pattern != CARD_PATTERN(code);
+        }
+        if (bad > 0) {
+                printf("-Bad: card_get() differs on %d cards\n", bad);
+                ++num_failed;
+        } else {
+                printf("-Good: card_get() deals what a shoe deals\n");
+        }
+
+        // the engines
+        if (arena_init(&arena, session_arena_size(1)) != SUCCESS ||
+            (Session = session_create(&arena, 1, SEED)) == NULL) {
+                printf("-Bad: could not create a session\n");
+                return 1;
+        }
+        rng_seed(&rng, SEED);
+        strategy_default(&Strategies[1]);
+        for (int r = 0; r < STRATEGY_ROWS; ++r) {
+                for (int u = 0; u < STRATEGY_UPCARDS; ++u) {
+                        Strategies[2].action[r][u] = rng_below(&rng, 2);
+                }
+        }
+        for (int s = 0; s < NUM_SHOES; ++s) {
+                for (int r = 0; r < NUM_RULES; ++r) {
+                        for (int p = 0; p < NUM_STRATEGIES; ++p) {
+                                config.shoe = s;
+                                config.rules.natural_payoff = payoffs[r / 2];
+                                config.rules.hit_soft_17 = r % 2;
+                                config.ref_rules = config.rules;
+                                config.strategy = p;
+                                // every option with every rule set and
+                                // strategy, over the shoes
+                                config.options = s % NUM_OPTIONS;
+                                if ((r + p) % 2) {
+                                        config.options |= OPTION_CONTROL;
+                                }
+                                num_failed += !run_config(&config,
+                                        rng_stream_seed(SEED, num_configs),
+                                        num_hands);
+                                ++num_configs;
+                        }
+                }
+        }
+        if (num_failed == 0) {
+                printf("-Good: every engine matches the reference in %d "
+                       "configurations, %llu hands each\n", num_configs,
+                       num_hands + BATCH_HANDS);
+        }
+
+        // the harness must catch a wrong dealer rule
+        config.shoe = 1;
+        rules_default(&config.rules);
+        config.ref_rules = config.rules;
+        config.ref_rules.hit_soft_17 = !config.rules.hit_soft_17;
+        config.strategy = 1;
+        config.options = 0;
+        Expecting_diff = TRUE;
+        if (run_config(&config, SEED, num_hands)) {
+                printf("-Bad: the soft 17 rule was not caught\n");
+                ++num_failed;
+        } else if (Diff_hand < 0) {
+                printf("-Good: a wrong soft 17 rule was caught (in a "
+                       "batch)\n");
+        } else {
+                printf("-Good: a wrong soft 17 rule was caught (hand "
+                       "%lld)\n", Diff_hand);
+        }
+
+        arena_free(&arena);
+        if (num_failed > 0) {
+                printf("-Bad: %d differential tests failed\n", num_failed);
+        } else {
+                printf("-Good: all differential tests passed\n");
+        }
+
+        return num_failed > 0;
+} // main()
+
+
+// end of test_diff.c
@@ -0,0 +1,541 @@
+// ----------------------------------------------------------------------
+// file: test_stats.c
+//
+// Description: This program tests the statistical quality of the deal
+//     path: the random number generator, rng_below() and the shoes.
+//     Every test deals millions of shoes on all processors and turns what
+//     it counted into a z score, a standard normal if the deal is fair:
+//         positions   chi-square of card against position in a shuffled
+//                     deck, and of pattern against position in 8 decks
+//         orders      chi-square over the 120 orders of five cards, in a
+//                     five-card shoe and within a full deck
+//         serial      correlation of the cards at one position in
+//                     consecutive shuffles, across a reshuffle, and in
+//                     shoes seeded from consecutive streams (all 0), and
+//                     of neighbours within a deck (-1/51)
+//         bias        chi-square of rng_below() for a bound where
+//                     "% bound" is heavily biased (which must fail), and
+//                     for 52
+//     A test fails if |z| > Z_LIMIT. The work is split into NUM_SLICES
+//     slices, each with its own random number stream, that the threads
+//     take in turn, so the results are the same for any number of
+//     threads.
+//     Usage: test_stats [-s scale] [-t threads]
+//     At scale 1 (the default) it deals about 450 million cards.
+//
+// Created: 2026-10-18
+//
+// ----------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "common.h"
+#include "rng.h"
+#include "card.h"
+
+#define NUM_SUITS 4
+#define CARDS_PER_SUIT 13
+
+#define Z_LIMIT 4.5
+#define MAX_THREADS 64
+#define NUM_SLICES 64
+#define SEED 20171103
+
+#define BIG_DECKS 8
+#define BIG_CARDS (BIG_DECKS * CARDS_PER_DECK)
+#define ORDER_CARDS 5
+#define NUM_ORDERS 120          // 5!
+#define BIAS_BOUND (UINT32_C(3) << 30)
+#define BIAS_BINS 3
+
+// Work at scale 1
+#define DECK_SHOES 4000000ULL           // one-deck shoes
+#define BIG_SHOES 200000ULL             // eight-deck shoes
+#define SMALL_SHOES 20000000ULL         // five-card shoes
+#define STREAM_SHOES 1000000ULL         // shoes seeded from streams
+#define BIAS_DRAWS 100000000ULL         // of each kind
+
+// Sums for a correlation
+struct corr_t {
+        double n;
+        double x;
+        double y;
+        double xx;
+        double yy;
+        double xy;
+};
+
+// What the tests count. Every thread adds up its slices in its own, and
+// the threads' counts are added up at the end.
+struct counts_t {
+        unsigned long long position[CARDS_PER_DECK][CARDS_PER_DECK];
+        unsigned long long big_position[BIG_CARDS][CARDS_PER_SUIT];
+        unsigned long long small_order[NUM_ORDERS];
+        unsigned long long deck_order[NUM_ORDERS];
+        struct corr_t same_position;    // same position, next shuffle
+        struct corr_t boundary;         // last card, first of next shuffle
+        struct corr_t neighbour;        // next card, same shuffle
+        struct corr_t streams;          // same position, next stream
+        unsigned long long below[BIAS_BINS];
+        unsigned long long modulo[BIAS_BINS];
+        unsigned long long below_52[CARDS_PER_DECK];
+};
+
+static struct counts_t Counts[MAX_THREADS];
+static struct counts_t Total;
+static double Scale = 1.0;
+static atomic_int Next_slice;
+
+
+
+// Work of one kind at the current scale for slice 'slice'
+static unsigned long long share(unsigned long long work, int slice)
+{
+        unsigned long long total = (unsigned long long)(work * Scale);
+
+        return total / NUM_SLICES + (slice < (int)(total % NUM_SLICES));
+} // share()
+
+
+
+static int card_index(unsigned char code)
+{
+        return (CARD_SUIT(code) - 1) * CARDS_PER_SUIT + CARD_PATTERN(code) - 1;
+} // card_index()
+
+
+
+static inline void corr_add(struct corr_t *c, double x, double y)
+{
+        c->n += 1;
+        c->x += x;
+        c->y += y;
+        c->xx += x * x;
+        c->yy += y * y;
+        c->xy += x * y;
+} // corr_add()
+
+
+
+static void corr_merge(struct corr_t *to, const struct corr_t *from)
+{
+        to->n += from->n;
+        to->x += from->x;
+        to->y += from->y;
+        to->xx += from->xx;
+        to->yy += from->yy;
+        to->xy += from->xy;
+} // corr_merge()
+
+
+
+// The index (0..NUM_ORDERS-1) of an order of ORDER_CARDS cards
+static int order_index(const int *order)
+{
+        int index = 0;
+
+        for (int i = 0; i < ORDER_CARDS; ++i) {
+                int smaller = 0;
+                for (int j = i + 1; j < ORDER_CARDS; ++j) {
+                        smaller += order[j] < order[i];
+                }
+                index = index * (ORDER_CARDS - i) + smaller;
+        }
+
+        return index;
+} // order_index()
+
+
+
+// Deal one-deck shoes: where each card lands, the order of the five
+// clubs A-5 within the deck, and the serial correlations.
+static void deal_decks(struct counts_t *counts, int slice)
+{
+        struct shoe_t shoe;
+        unsigned char last[CARDS_PER_DECK];
+        unsigned char deck[CARDS_PER_DECK];
+        unsigned long long num = share(DECK_SHOES, slice);
+        int order[ORDER_CARDS];
+
+        shoe_init(&shoe, 1, rng_stream_seed(SEED, slice));
+        for (int i = 0; i < CARDS_PER_DECK; ++i) {
+                last[i] = shoe_deal(&shoe);
+        }
+        for (unsigned long long s = 0; s < num; ++s) {
+                int marked = 0;
+                int p = s % (CARDS_PER_DECK - 1);
+
+                // the shoe reshuffles itself at the first card
+                for (int i = 0; i < CARDS_PER_DECK; ++i) {
+                        unsigned char code = shoe_deal(&shoe);
+                        deck[i] = code;
+                        ++counts->position[i][card_index(code)];
+                        if (CARD_SUIT(code) == CLUBS &&
+                            CARD_PATTERN(code) <= ORDER_CARDS) {
+                                order[marked++] = CARD_PATTERN(code);
+                        }
+                        corr_add(&counts->same_position,
+                                 CARD_PATTERN(last[i]), CARD_PATTERN(code));
+                }
+                ++counts->deck_order[order_index(order)];
+                corr_add(&counts->boundary,
+                         CARD_PATTERN(last[CARDS_PER_DECK - 1]),
+                         CARD_PATTERN(deck[0]));
+                // one pair per shoe, so the pairs are independent
+                corr_add(&counts->neighbour, CARD_PATTERN(deck[p]),
+                         CARD_PATTERN(deck[p + 1]));
+                memcpy(last, deck, sizeof(last));
+        }
+} // deal_decks()
+
+
+
+// Deal eight-deck shoes: which pattern lands at each position.
+static void deal_big_shoes(struct counts_t *counts, int slice)
+{
+        struct shoe_t shoe;
+        unsigned long long num = share(BIG_SHOES, slice);
+
+        shoe_init(&shoe, BIG_DECKS,
+                  rng_stream_seed(SEED + 1, slice));
+        for (unsigned long long s = 0; s < num; ++s) {
+                for (int i = 0; i < BIG_CARDS; ++i) {
+                        unsigned char code = shoe_deal(&shoe);
+                        ++counts->big_position[i][CARD_PATTERN(code) - 1];
+                }
+        }
+} // deal_big_shoes()
+
+
+
+// Deal five-card fixed-composition shoes of A-5: the order they come in.
+static void deal_small_shoes(struct counts_t *counts, int slice)
+{
+        struct shoe_t shoe;
+        unsigned short full[KING + 1] = { 0 };
+        unsigned long long num = share(SMALL_SHOES, slice);
+        int order[ORDER_CARDS];
+
+        for (int m = ACE; m <= ORDER_CARDS; ++m) {
+                full[m] = 1;
+        }
+        shoe_init_counts(&shoe, full, rng_stream_seed(SEED + 2, slice));
+        for (unsigned long long s = 0; s < num; ++s) {
+                for (int i = 0; i < ORDER_CARDS; ++i) {
+                        order[i] = CARD_PATTERN(shoe_deal(&shoe));
+                }
+                ++counts->small_order[order_index(order)];
+        }
+} // deal_small_shoes()
+
+
+
+// Shuffle one-deck shoes seeded from consecutive streams of one seed,
+// as the simulator seeds its chunks, and compare neighbouring streams.
+static void deal_streams(struct counts_t *counts, int slice)
+{
+        struct shoe_t shoe;
+        unsigned char last[CARDS_PER_DECK];
+        unsigned long long num = share(STREAM_SHOES, slice);
+        unsigned long long first = 0;
+
+        for (int i = 0; i < slice; ++i) {
+                first += share(STREAM_SHOES, i);
+        }
+        for (unsigned long long s = first; s <= first + num; ++s) {
+                shoe_init(&shoe, 1, rng_stream_seed(SEED + 3, s));
+                for (int i = 0; i < CARDS_PER_DECK; ++i) {
+                        unsigned char code = shoe_deal(&shoe);
+                        if (s > first) {
+                                corr_add(&counts->streams,
+                                         CARD_PATTERN(last[i]),
+                                         CARD_PATTERN(code));
+                        }
+                        last[i] = code;
+                }
+        }
+} // deal_streams()
+
+
+
+// Draw from rng_below() and from "% bound", for a bound of 3/4 of the
+// 32-bit range, binned by thirds of the bound.
+static void draw_below(struct counts_t *counts, int slice)
+{
+        struct rng_t rng;
+        unsigned long long num = share(BIAS_DRAWS, slice);
+
+        rng_seed(&rng, rng_stream_seed(SEED + 4, slice));
+        for (unsigned long long i = 0; i < num; ++i) {
+                uint32_t bits = (uint32_t)(rng_next(&rng) >> 32);
+                ++counts->below[rng_below(&rng, BIAS_BOUND) >> 30];
+                ++counts->modulo[(bits % BIAS_BOUND) >> 30];
+                ++counts->below_52[rng_below(&rng, CARDS_PER_DECK)];
+        }
+} // draw_below()
+
+
+
+static void *worker_main(void *arg)
+{
+        struct counts_t *counts = arg;
+        int slice;
+
+        while ((slice = atomic_fetch_add(&Next_slice, 1)) < NUM_SLICES) {
+                deal_decks(counts, slice);
+                deal_big_shoes(counts, slice);
+                deal_small_shoes(counts, slice);
+                deal_streams(counts, slice);
+                draw_below(counts, slice);
+        }
+
+        return NULL;
+} // worker_main()
+
+
+
+static void add_counts(struct counts_t *to, const struct counts_t *from)
+{
+        unsigned long long *t = (unsigned long long *)to->position;
+        const unsigned long long *f = (const unsigned long long *)
+                                      from->position;
+
+        for (size_t i = 0; i < sizeof(to->position) / sizeof(*t); ++i) {
+                t[i] += f[i];
+        }
+        t = (unsigned long long *)to->big_position;
+        f = (const unsigned long long *)from->big_position;
+        for (size_t i = 0; i < sizeof(to->big_position) / sizeof(*t); ++i) {
+                t[i] += f[i];
+        }
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+                to->small_order[i] += from->small_order[i];
+                to->deck_order[i] += from->deck_order[i];
+        }
+        corr_merge(&to->same_position, &from->same_position);
+        corr_merge(&to->boundary, &from->boundary);
+        corr_merge(&to->neighbour, &from->neighbour);
+        corr_merge(&to->streams, &from->streams);
+        for (int i = 0; i < BIAS_BINS; ++i) {
+                to->below[i] += from->below[i];
+                to->modulo[i] += from->modulo[i];
+        }
+        for (int i = 0; i < CARDS_PER_DECK; ++i) {
+                to->below_52[i] += from->below_52[i];
+        }
+} // add_counts()
+
+
+
+// Wilson-Hilferty: a chi-square with 'df' degrees of freedom as a
+// standard normal.
+static double chi_square_z(double chi_square, double df)
+{
+        double v = 2.0 / (9.0 * df);
+
+        return (cbrt(chi_square / df) - (1.0 - v)) / sqrt(v);
+} // chi_square_z()
+
+
+
+// Pearson's chi-square of 'num' counts against the probabilities
+// expected[i] / sum of expected.
+static double chi_square(const unsigned long long *counts,
+                         const double *expected, int num)
+{
+        double n = 0;
+        double weight = 0;
+        double sum = 0;
+
+        for (int i = 0; i < num; ++i) {
+                n += counts[i];
+                weight += expected[i];
+        }
+        for (int i = 0; i < num; ++i) {
+                double e = n * expected[i] / weight;
+                sum += (counts[i] - e) * (counts[i] - e) / e;
+        }
+
+        return sum;
+} // chi_square()
+
+
+
+// The z score of a table of 'rows' positions by 'cols' equally likely
+// kinds of card, from shoes of 'rows' cards. Each shoe fills every row
+// once and every column equally, which shrinks the degrees of freedom to
+// (rows - 1) * (cols - 1) and inflates Pearson's statistic by
+// rows / (rows - 1) over a chi-square with that many.
+static double position_z(const unsigned long long *counts, int rows,
+                         int cols)
+{
+        double expected[CARDS_PER_DECK];
+        double sum = 0;
+
+        for (int c = 0; c < cols; ++c) {
+                expected[c] = 1;
+        }
+        for (int r = 0; r < rows; ++r) {
+                sum += chi_square(&counts[r * cols], expected, cols);
+        }
+        sum *= (rows - 1.0) / rows;
+
+        return chi_square_z(sum, (rows - 1.0) * (cols - 1.0));
+} // position_z()
+
+
+
+static double order_z(const unsigned long long *counts)
+{
+        double expected[NUM_ORDERS];
+
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+                expected[i] = 1;
+        }
+
+        return chi_square_z(chi_square(counts, expected, NUM_ORDERS),
+                            NUM_ORDERS - 1);
+} // order_z()
+
+
+
+// The z score of the correlation in 'c' against 'rho' (Fisher's
+// approximation for large n).
+static double corr_z(const struct corr_t *c, double rho, double *r)
+{
+        double cov = c->xy / c->n - (c->x / c->n) * (c->y / c->n);
+        double var_x = c->xx / c->n - (c->x / c->n) * (c->x / c->n);
+        double var_y = c->yy / c->n - (c->y / c->n) * (c->y / c->n);
+
+        *r = cov / sqrt(var_x * var_y);
+        return (atanh(*r) - atanh(rho)) * sqrt(c->n - 3);
+} // corr_z()
+
+
+
+// Print a result and return 1 if it failed, 0 if not.
+static int report(const char *test, double z)
+{
+        int failed = !(fabs(z) <= Z_LIMIT);
+
+        printf("-%s: %-50s z = %7.2f\n", failed ? "Bad" : "Good", test, z);
+        return failed;
+} // report()
+
+
+
+int main(int argc, char *argv[])
+{
+        pthread_t threads[MAX_THREADS];
+        double third[BIAS_BINS] = { 1, 1, 1 };
+        double flat[CARDS_PER_DECK];
+        double z;
+        double r;
+        int num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+        int num_failed = 0;
+        int opt;
+
+        while ((opt = getopt(argc, argv, "s:t:")) != -1) {
+                switch (opt) {
+                case 's':
+                        Scale = atof(optarg);
+                        break;
+                case 't':
+                        num_threads = atoi(optarg);
+                        break;
+                default:
+                        fprintf(stderr, "usage: %s [-s scale] "
+                                "[-t threads]\n", argv[0]);
+                        return 1;
+                }
+        }
+        if (num_threads < 1) {
+                num_threads = 1;
+        }
+        if (num_threads > MAX_THREADS) {
+                num_threads = MAX_THREADS;
+        }
+        if (!(Scale > 0)) {
+                fprintf(stderr, "%s: the scale must be positive\n", argv[0]);
+                return 1;
+        }
+
+        atomic_store(&Next_slice, 0);
+        for (int i = 0; i < num_threads; ++i) {
+                if (pthread_create(&threads[i], NULL, worker_main,
+                                   &Counts[i]) != 0) {
+                        // the threads started take the remaining slices
+                        num_threads = i;
+                        break;
+                }
+        }
+        if (num_threads == 0) {
+                worker_main(&Counts[0]);
+                num_threads = 1;
+        }
+        for (int i = 0; i < num_threads; ++i) {
+                pthread_join(threads[i], NULL);
+        }
+        for (int i = 0; i < num_threads; ++i) {
+                add_counts(&Total, &Counts[i]);
+        }
+
+        num_failed += report("card against position, 1 deck",
+                             position_z(&Total.position[0][0],
+                                        CARDS_PER_DECK, CARDS_PER_DECK));
+        num_failed += report("pattern against position, 8 decks",
+                             position_z(&Total.big_position[0][0],
+                                        BIG_CARDS, CARDS_PER_SUIT));
+        num_failed += report("orders of a five-card shoe",
+                             order_z(Total.small_order));
+        num_failed += report("orders of five cards within a deck",
+                             order_z(Total.deck_order));
+
+        z = corr_z(&Total.same_position, 0, &r);
+        num_failed += report("same position in consecutive shuffles", z);
+        z = corr_z(&Total.boundary, 0, &r);
+        num_failed += report("last card, first card after reshuffle", z);
+        z = corr_z(&Total.neighbour, -1.0 / (CARDS_PER_DECK - 1), &r);
+        num_failed += report("neighbours within a deck (-1/51)", z);
+        z = corr_z(&Total.streams, 0, &r);
+        num_failed += report("same position in consecutive streams", z);
+
+        num_failed += report("rng_below(3 << 30) by thirds",
+                             chi_square_z(chi_square(Total.below, third,
+                                                     BIAS_BINS),
+                                          BIAS_BINS - 1));
+        for (int i = 0; i < CARDS_PER_DECK; ++i) {
+                flat[i] = 1;
+        }
+        num_failed += report("rng_below(52)",
+                             chi_square_z(chi_square(Total.below_52, flat,
+                                                     CARDS_PER_DECK),
+                                          CARDS_PER_DECK - 1));
+
+        // the same test must catch the bias of "% bound"
+        z = chi_square_z(chi_square(Total.modulo, third, BIAS_BINS),
+                         BIAS_BINS - 1);
+        if (z > Z_LIMIT) {
+                printf("-Good: %-50s z = %7.2f\n",
+                       "\"% (3 << 30)\" is caught as biased", z);
+        } else {
+                printf("-Bad: %-51s z = %7.2f\n",
+                       "\"% (3 << 30)\" was not caught as biased", z);
+                ++num_failed;
+        }
+
+        if (num_failed > 0) {
+                printf("-Bad: %d statistical tests failed\n", num_failed);
+        } else {
+                printf("-Good: all statistical tests passed\n");
+        }
+
+        return num_failed > 0;
+} // main()
+
+
+// end of test_stats.c